@@ -0,0 +1,268 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Main file of the benchmark of the parser and the maximum flow solvers on synthetic networks
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "../lib/Graph.hpp"
+#include "../lib/Parser.hpp"
+#include "../lib/Stats.hpp"
+#include "Generator.hpp"
+
+//! Settings of a run of the benchmark
+struct BenchmarkOptions {
+    std::vector<unsigned> sizes = {1000, 10000, 100000};    /*!< Pipes of each network */
+    std::vector<max_flow_algorithm> algorithms = {EDMONDS_KARP, FORD_FULKERSON, DINIC, PUSH_RELABEL};
+    GeneratorOptions network;                               /*!< Shape of the networks, pipes taken from sizes */
+    unsigned threads = 0;                                   /*!< Threads of the components, dependencies and removals (0 uses one per core) */
+    unsigned dependencies = 5;                              /*!< Most populous Cities whose dependencies are calculated */
+    unsigned removals = 100;                                /*!< Pumping Stations removed, each in a scenario of its own */
+    unsigned repetitions = 1;                               /*!< Runs of each phase, the fastest one being printed */
+    bool balance = true;                                    /*!< Whether the flow is balanced, the slowest phase on large networks */
+};
+
+/**
+ * @brief Runs a phase several times and prints a CSV row with the fastest run
+ * @param const std::string& prefix: first columns of the row (pipes, locations, arcs)
+ * @param const std::string& phase: name of the phase
+ * @param unsigned repetitions: number of runs
+ * @param const std::function<void()>& prepare: brings the network back to the state the phase starts from, not timed
+ * @param const std::function<std::pair<Capacity, unsigned>()>& run: phase, returning the flow and the iterations of the last solver
+ * @return void
+ * @note The counters are the ones of the fastest run, and 0 when built with -DNO_STATS
+ * @note This function is static
+ * @note Time Complexity: repetitions times the one of the phase, Space Complexity: O(1)
+ */
+static void measure(const std::string &prefix, const std::string &phase, unsigned repetitions,
+                    const std::function<void()> &prepare, const std::function<std::pair<Capacity, unsigned>()> &run) {
+    double best = -1;
+    std::pair<Capacity, unsigned> result;
+    uint64_t searches = 0, arcs = 0;
+    for (unsigned r = 0; r < repetitions; r++) {
+        prepare();
+        Stats::reset();
+        auto start = std::chrono::steady_clock::now();
+        std::pair<Capacity, unsigned> current = run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (best < 0 || seconds < best) {
+            best = seconds;
+            result = current;
+            searches = Stats::get(STAT_SEARCHES);
+            arcs = Stats::get(STAT_ARCS_SCANNED);
+        }
+    }
+    std::cout << prefix << ',' << phase << ',' << best << ',' << result.first << ',' << result.second << ','
+              << searches << ',' << arcs << std::endl;
+}
+
+/**
+ * @brief Generates a network of each size and times the parser, every algorithm from scratch, the components, the dependencies, removals and balancing
+ * @param const BenchmarkOptions& options: settings
+ * @param const std::string& directory: where the networks are written
+ * @return bool: false if a network could not be generated
+ * @note This function is static
+ * @note Time Complexity: the one of the slowest algorithm on the largest network, Space Complexity: O(V + E)
+ */
+static bool benchmark(const BenchmarkOptions &options, const std::string &directory) {
+    std::cout.precision(12);
+    std::cout << "pipes,locations,arcs,phase,seconds,flow,iterations,searches,arcs_scanned" << std::endl;
+    for (unsigned size: options.sizes) {
+        GeneratorOptions shape = options.network;
+        shape.pipes = size;
+        GeneratedNetwork files;
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        if (!generateNetwork(shape, directory, files, error)) {
+            std::cerr << "Error: " << error << '\n';
+            return false;
+        }
+        double generation = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Graph network;
+        network.setThreads(options.threads);
+        network.setAlgorithm(options.algorithms[0]);
+        std::ostringstream discarded; // the parser reports each file on the standard output
+        std::streambuf *output = std::cout.rdbuf(discarded.rdbuf());
+        start = std::chrono::steady_clock::now();
+        parse(network, files.cities, files.pipes, files.reservoirs, files.stations);
+        double parsing = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout.rdbuf(output);
+
+        std::ostringstream prefix;
+        prefix << files.pipeCount << ',' << files.locations << ',' << network.getResidual().arcCount();
+        std::cout << prefix.str() << ",generate," << generation << ",0,0,0,0\n"
+                  << prefix.str() << ",parse," << parsing << ",0,0,0,0" << std::endl;
+
+        auto reset = [&network]() { network.reset(); };
+        for (max_flow_algorithm algorithm: options.algorithms) {
+            measure(prefix.str(), Graph::algorithmName(algorithm), options.repetitions, reset, [&network, algorithm]() {
+                unsigned iterations = 0;
+                switch (algorithm) {
+                    case EDMONDS_KARP: iterations = network.edmondsKarp(); break;
+                    case FORD_FULKERSON: network.fordFulkerson(&iterations); break;
+                    case DINIC: iterations = network.dinic(); break;
+                    case PUSH_RELABEL: iterations = network.pushRelabel(); break;
+                }
+                return std::make_pair(network.getFlow(), iterations);
+            });
+        }
+        measure(prefix.str(), "components_" + Graph::algorithmName(options.algorithms[0]), options.repetitions, reset, [&network]() {
+            unsigned iterations = network.maxFlow();
+            return std::make_pair(network.getFlow(), iterations);
+        });
+
+        // the analyses start from the flow of the components, the one the program uses
+        std::vector<Vertex *> cities;
+        for (auto p: network.getCityVertexes())
+            cities.push_back(p.second);
+        std::sort(cities.begin(), cities.end(), [](const Vertex *a, const Vertex *b) {
+            return a->getPopulation() != b->getPopulation() ? a->getPopulation() > b->getPopulation() : a->getTypeId() < b->getTypeId();
+        });
+        cities.resize(std::min<size_t>(cities.size(), options.dependencies));
+        measure(prefix.str(), "dependency", options.repetitions, []() {}, [&network, &cities]() {
+            network.calculateDependency(cities);
+            unsigned entries = 0;
+            for (Vertex *c: cities)
+                entries += c->getDependency().size();
+            return std::make_pair(network.getFlow(), entries);
+        });
+
+        std::vector<std::vector<FailurePoint>> scenarios;
+        const unsigned stations = network.getStationVertexes().size();
+        for (unsigned i = 0; i < options.removals && stations > 0; i++) // spread evenly over the Pumping Stations, by ID
+            scenarios.push_back({{nullptr, network.findVertex(STATION, 1 + (unsigned) ((uint64_t) i * stations / options.removals) % stations)}});
+        measure(prefix.str(), "removals", options.repetitions, []() {}, [&network, &scenarios]() {
+            std::vector<RemovalReport> reports = network.evaluateRemovals(scenarios);
+            Capacity lowest = network.getFlow();
+            for (const RemovalReport &r: reports)
+                lowest = std::min(lowest, r.flow);
+            return std::make_pair(lowest, (unsigned) reports.size());
+        });
+
+        // balancing changes the flow, so each run starts again from the one of the components
+        if (options.balance) {
+            measure(prefix.str(), "balance", options.repetitions, [&network]() { network.reset(); network.maxFlow(); }, [&network]() {
+                BalanceReport report = network.balanceFlow();
+                return std::make_pair(network.getFlow(), report.augmentations);
+            });
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a list of numbers separated by commas
+ * @param const std::string& text: list, like 1000,10000
+ * @param std::vector<unsigned>& numbers: filled with the numbers
+ * @return bool: false if the list is empty or has something that is not a positive number
+ * @note This function is static
+ * @note Time Complexity: O(n), Space Complexity: O(n)
+ */
+static bool parseSizes(const std::string &text, std::vector<unsigned> &numbers) {
+    numbers.clear();
+    std::istringstream in(text);
+    std::string item;
+    while (getline(in, item, ',')) {
+        if (item.empty() || item.find_first_not_of("0123456789") != std::string::npos || std::stoul(item) == 0)
+            return false;
+        numbers.push_back(std::stoul(item));
+    }
+    return !numbers.empty();
+}
+
+/**
+ * @brief Reads a list of algorithms separated by commas
+ * @param const std::string& text: list, like dinic,push_relabel
+ * @param std::vector<max_flow_algorithm>& algorithms: filled with the algorithms
+ * @return bool: false if the list is empty or has a name that is not an algorithm
+ * @note This function is static
+ * @note Time Complexity: O(n), Space Complexity: O(n)
+ */
+static bool parseAlgorithms(const std::string &text, std::vector<max_flow_algorithm> &algorithms) {
+    algorithms.clear();
+    std::istringstream in(text);
+    std::string item;
+    max_flow_algorithm algorithm;
+    while (getline(in, item, ',')) {
+        if (!Graph::parseAlgorithm(item, algorithm))
+            return false;
+        algorithms.push_back(algorithm);
+    }
+    return !algorithms.empty();
+}
+
+//! Prints one CSV row per network size and phase, so runs of different revisions can be compared
+//! Usage: ./benchmark [-p pipes,...] [-a algorithm,...] [-d density] [-b bidirectional] [-w window] [-s seed] [-j threads]
+//!                    [-c cities] [-k removals] [-r repetitions] [-n] [-o directory]
+//!     -p: pipes of each network (1000,10000,100000 by default, up to about 1000000)
+//!     -a: algorithms run from scratch (all by default); the first one also solves the components and the analyses
+//!     -d, -b, -w, -s: density, bidirectional ratio, window and seed of the generator (see ./generator)
+//!     -j: threads of the components, dependencies and removals (0, the default, uses one per core)
+//!     -c: most populous Cities whose dependencies are calculated (5 by default)
+//!     -k: Pumping Stations removed, one per scenario (100 by default)
+//!     -r: runs of each phase, the fastest being printed (1 by default)
+//!     -n: skips the balancing of the flow
+//!     -o: directory of the generated files (a new temporary directory by default, removed at the end)
+int main(int argc, char *argv[]) {
+    BenchmarkOptions options;
+    std::string directory;
+    bool valid = true;
+    for (int i = 1; i < argc && valid; i++) {
+        try {
+            if (!strcmp(argv[i], "-p") && i + 1 < argc) valid = parseSizes(argv[++i], options.sizes);
+            else if (!strcmp(argv[i], "-a") && i + 1 < argc) valid = parseAlgorithms(argv[++i], options.algorithms);
+            else if (!strcmp(argv[i], "-d") && i + 1 < argc) options.network.density = std::stod(argv[++i]);
+            else if (!strcmp(argv[i], "-b") && i + 1 < argc) options.network.bidirectional = std::stod(argv[++i]);
+            else if (!strcmp(argv[i], "-w") && i + 1 < argc) options.network.window = std::stoul(argv[++i]);
+            else if (!strcmp(argv[i], "-s") && i + 1 < argc) options.network.seed = std::stoull(argv[++i]);
+            else if (!strcmp(argv[i], "-j") && i + 1 < argc) options.threads = std::stoul(argv[++i]);
+            else if (!strcmp(argv[i], "-c") && i + 1 < argc) options.dependencies = std::stoul(argv[++i]);
+            else if (!strcmp(argv[i], "-k") && i + 1 < argc) options.removals = std::stoul(argv[++i]);
+            else if (!strcmp(argv[i], "-r") && i + 1 < argc) options.repetitions = std::max(1ul, std::stoul(argv[++i]));
+            else if (!strcmp(argv[i], "-n")) options.balance = false;
+            else if (!strcmp(argv[i], "-o") && i + 1 < argc) directory = argv[++i];
+            else valid = false;
+        } catch (...) {
+            valid = false;
+        }
+    }
+    if (!valid) {
+        std::cerr << "Usage: " << argv[0] << " [-p pipes,...] [-a algorithm,...] [-d density] [-b bidirectional] [-w window] [-s seed] [-j threads]"
+                  << " [-c cities] [-k removals] [-r repetitions] [-n] [-o directory]\n";
+        return 1;
+    }
+
+    bool temporary = directory.empty();
+    if (temporary) {
+        const char *base = std::getenv("TMPDIR");
+        std::string pattern = std::string(base != nullptr ? base : "/tmp") + "/networkXXXXXX";
+        std::vector<char> path(pattern.begin(), pattern.end());
+        path.push_back('\0');
+        if (mkdtemp(path.data()) == nullptr) {
+            std::cerr << "Error: the directory " << pattern << " could not be created.\n";
+            return 1;
+        }
+        directory = path.data();
+    }
+    bool ok = benchmark(options, directory);
+    if (temporary) {
+        for (const char *file: {"/Cities.csv", "/Pipes.csv", "/Reservoirs.csv", "/Stations.csv"})
+            std::remove((directory + file).c_str());
+        rmdir(directory.c_str());
+    }
+    return ok ? 0 : 1;
+}
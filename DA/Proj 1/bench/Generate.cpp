@@ -0,0 +1,53 @@
+/**
+ * @file Generate.cpp
+ * @brief Main file of the generator of synthetic networks
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "Generator.hpp"
+
+//! Usage: ./generator <directory> [-p pipes] [-d density] [-b bidirectional] [-c cities] [-r reservoirs] [-w window] [-s seed]
+//!     -p: number of pipes (10000 by default)
+//!     -d: pipes per location (2 by default)
+//!     -b: fraction of the pipes that are bidirectional (0.1 by default)
+//!     -c, -r: fraction of the locations that are Cities (0.15) and Reservoirs (0.05), the rest being Pumping Stations
+//!     -w: how far apart, in the order of the network, the locations joined by a pipe can be (32 by default)
+//!     -s: seed of the random numbers (1 by default)
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    std::string directory;
+    for (int i = 1; i < argc; i++) {
+        try {
+            if (!strcmp(argv[i], "-p") && i + 1 < argc) options.pipes = std::stoul(argv[++i]);
+            else if (!strcmp(argv[i], "-d") && i + 1 < argc) options.density = std::stod(argv[++i]);
+            else if (!strcmp(argv[i], "-b") && i + 1 < argc) options.bidirectional = std::stod(argv[++i]);
+            else if (!strcmp(argv[i], "-c") && i + 1 < argc) options.cities = std::stod(argv[++i]);
+            else if (!strcmp(argv[i], "-r") && i + 1 < argc) options.reservoirs = std::stod(argv[++i]);
+            else if (!strcmp(argv[i], "-w") && i + 1 < argc) options.window = std::stoul(argv[++i]);
+            else if (!strcmp(argv[i], "-s") && i + 1 < argc) options.seed = std::stoull(argv[++i]);
+            else if (argv[i][0] != '-' && directory.empty()) directory = argv[i];
+            else throw std::invalid_argument(argv[i]);
+        } catch (...) {
+            directory.clear();
+            break;
+        }
+    }
+    if (directory.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <directory> [-p pipes] [-d density] [-b bidirectional] [-c cities] [-r reservoirs] [-w window] [-s seed]\n";
+        return 1;
+    }
+
+    GeneratedNetwork network;
+    std::string error;
+    if (!generateNetwork(options, directory, network, error)) {
+        std::cerr << "Error: " << error << '\n';
+        return 1;
+    }
+    std::cout << network.locations << " locations and " << network.pipeCount << " pipes written to " << directory << '\n';
+    return 0;
+}
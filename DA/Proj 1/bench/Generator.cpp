@@ -0,0 +1,129 @@
+/**
+ * @file Generator.cpp
+ * @brief Definition of the generator of synthetic networks
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "Generator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+//! Random numbers that are the same on every standard library: std::mt19937_64 is fully specified, its distributions are not
+class Random {
+private:
+    std::mt19937_64 engine;
+
+public:
+    explicit Random(uint64_t seed) : engine(seed) {}
+
+    //! Returns a number in [0, n), n > 0
+    uint64_t below(uint64_t n) { return engine() % n; }
+
+    //! Returns a number in [low, high]
+    uint64_t between(uint64_t low, uint64_t high) { return low + below(high - low + 1); }
+
+    //! Returns a number in [0, 1)
+    double unit() { return (double) (engine() >> 11) / 9007199254740992.0; }
+};
+
+//! Time Complexity: O(P + V), Space Complexity: O(P + V)
+bool generateNetwork(const GeneratorOptions &options, const std::string &directory, GeneratedNetwork &network, std::string &error) {
+    if (options.pipes == 0 || !(options.density >= 1) || options.density > options.window / 2.0) {
+        error = "the density must be between 1 and half the window.";
+        return false;
+    }
+    if (!(options.cities > 0) || !(options.reservoirs > 0) || options.cities + options.reservoirs > 1 ||
+        options.bidirectional < 0 || options.bidirectional > 1) {
+        error = "the shares of cities and reservoirs and the bidirectional ratio must be between 0 and 1.";
+        return false;
+    }
+
+    const unsigned n = std::max(3u, (unsigned) std::lround(options.pipes / options.density));
+    const unsigned cities = std::max(1u, (unsigned) std::lround(n * options.cities));
+    const unsigned reservoirs = std::max(1u, (unsigned) std::lround(n * options.reservoirs));
+    if (cities + reservoirs > n) {
+        error = "there are too few pipes for a city and a reservoir.";
+        return false;
+    }
+    Random random(options.seed);
+
+    // the order of the locations along the network, each numbered among the ones of its type in that order
+    enum { CITY, RESERVOIR, STATION };
+    std::vector<unsigned char> type(n, STATION);
+    std::fill(type.begin(), type.begin() + cities, CITY);
+    std::fill(type.begin() + cities, type.begin() + cities + reservoirs, RESERVOIR);
+    for (unsigned i = n - 1; i > 0; i--)
+        std::swap(type[i], type[random.below(i + 1)]);
+    std::vector<unsigned> id(n);
+    unsigned counts[3] = {0, 0, 0};
+    for (unsigned i = 0; i < n; i++)
+        id[i] = ++counts[type[i]];
+    const char *prefixes[3] = {"C_", "R_", "PS_"};
+    auto code = [&](unsigned i) { return prefixes[type[i]] + std::to_string(id[i]); };
+
+    network.cities = directory + "/Cities.csv";
+    network.pipes = directory + "/Pipes.csv";
+    network.reservoirs = directory + "/Reservoirs.csv";
+    network.stations = directory + "/Stations.csv";
+    network.locations = n;
+    std::ofstream citiesFile(network.cities), pipesFile(network.pipes), reservoirsFile(network.reservoirs),
+            stationsFile(network.stations);
+    if (!citiesFile.is_open() || !pipesFile.is_open() || !reservoirsFile.is_open() || !stationsFile.is_open()) {
+        error = "the files could not be written to " + directory + ".";
+        return false;
+    }
+
+    citiesFile << "City,Id,Code,Demand,Population\n";
+    reservoirsFile << "Reservoir,Municipality,Id,Code,Maximum Delivery (m3/sec)\n";
+    stationsFile << "Id,Code\n";
+    for (unsigned i = 0; i < n; i++) {
+        switch (type[i]) {
+            case CITY: {
+                unsigned demand = random.between(20, 1000);
+                citiesFile << "City " << id[i] << ',' << id[i] << ',' << code(i) << ',' << demand << ".00,"
+                           << demand * 150 + random.below(1000) << '\n';
+                break;
+            }
+            case RESERVOIR:
+                reservoirsFile << "Reservoir " << id[i] << ",Municipality " << id[i] % 50 + 1 << ',' << id[i] << ','
+                               << code(i) << ',' << random.between(500, 5000) << '\n';
+                break;
+            default:
+                stationsFile << id[i] << ',' << code(i) << '\n';
+        }
+    }
+
+    // every pipe goes from i to a j after it, at most window places away; each pair is used once
+    std::unordered_set<uint64_t> used;
+    used.reserve(options.pipes);
+    pipesFile << "Service_Point_A,Service_Point_B,Capacity,Direction\n";
+    auto write = [&](unsigned i, unsigned j) {
+        if (!used.insert((uint64_t) i << 32 | j).second)
+            return;
+        pipesFile << code(i) << ',' << code(j) << ',' << random.between(10, 1000) << ','
+                  << (random.unit() < options.bidirectional ? 0 : 1) << '\n';
+    };
+    auto upstream = [&](unsigned j) { return j - 1 - (unsigned) random.below(std::min(options.window, j)); };
+    for (unsigned j = 1; j < n && used.size() < options.pipes; j++) // joins every location to the network
+        write(upstream(j), j);
+    while (used.size() < options.pipes) {
+        unsigned j = 1 + random.below(n - 1);
+        write(upstream(j), j);
+    }
+    network.pipeCount = used.size();
+
+    citiesFile.close();
+    pipesFile.close();
+    reservoirsFile.close();
+    stationsFile.close();
+    if (citiesFile.fail() || pipesFile.fail() || reservoirsFile.fail() || stationsFile.fail()) {
+        error = "the files could not be written to " + directory + ".";
+        return false;
+    }
+    return true;
+}
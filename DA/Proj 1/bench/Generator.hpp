@@ -0,0 +1,45 @@
+/**
+ * @file Generator.hpp
+ * @brief Declaration of the generator of synthetic networks
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include <cstdint>
+#include <string>
+
+//! Parameters of a synthetic network
+struct GeneratorOptions {
+    unsigned pipes = 10000;                     /*!< Lines of the pipes file (a bidirectional pipe is one line) */
+    double density = 2;                         /*!< Pipes per location */
+    double bidirectional = 0.1;                 /*!< Fraction of the pipes that are bidirectional */
+    double cities = 0.15;                       /*!< Fraction of the locations that are Cities */
+    double reservoirs = 0.05;                   /*!< Fraction of the locations that are Reservoirs */
+    unsigned window = 32;                       /*!< A pipe joins locations at most this far apart in the order of the network */
+    uint64_t seed = 1;                          /*!< The same options and seed give the same files on every machine */
+};
+
+//! Files and size of a generated network
+struct GeneratedNetwork {
+    std::string cities, pipes, reservoirs, stations;    /*!< Paths of the four files, in the order parse() takes them */
+    unsigned locations = 0;                             /*!< Cities, Reservoirs and Pumping Stations */
+    unsigned pipeCount = 0;                             /*!< Lines of the pipes file */
+};
+
+/**
+ * @brief Writes the Cities, Pipes, Reservoirs and Stations files of a random network, in the format of the datasets
+ * @param const GeneratorOptions& options: size and shape of the network
+ * @param const std::string& directory: existing directory the files are written to
+ * @param GeneratedNetwork& network: filled with the paths of the files and the size of the network
+ * @param std::string& error: why the network could not be generated
+ * @return bool: false if the options are not valid or a file could not be written
+ * @note The locations are shuffled into a line and every pipe goes downstream, from a location to one at most window places after it,
+ * so the water follows long paths from the Reservoirs to the Cities; the first pipes join each location to one before it
+ * @note Time Complexity: O(P + V), Space Complexity: O(P + V)
+ */
+bool generateNetwork(const GeneratorOptions &options, const std::string &directory, GeneratedNetwork &network, std::string &error);
+
+#endif // GENERATOR_HPP
@@ -0,0 +1,152 @@
+/**
+ * @file Arena.hpp
+ * @brief Declaration and definition of class template Arena
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "Stats.hpp"
+
+//! Bump-pointer storage for the objects of a Graph: they are created one after the other in blocks and only freed with the arena
+//! Objects created in sequence are contiguous in memory, and each one has an index, its position in creation order
+template<typename T>
+class Arena {
+private:
+    static const size_t BLOCK_SIZE = 256;                               /*!< Objects per block */
+
+    //! Uninitialised room for BLOCK_SIZE objects
+    struct Block {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[BLOCK_SIZE];
+    };
+
+    std::vector<std::unique_ptr<Block>> blocks;                         /*!< Blocks in creation order, all full but the last */
+    std::vector<std::pair<const T *, size_t>> sorted;                   /*!< Start of each block and its position, sorted by address */
+    size_t count = 0;                                                   /*!< Number of objects created */
+
+public:
+    /**
+     * @brief Creates an empty arena, without any block
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Arena() = default;
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief Takes the blocks of another arena, leaving it empty
+     * @param Arena&& other: arena to move
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Arena(Arena &&other) noexcept : blocks(std::move(other.blocks)), sorted(std::move(other.sorted)), count(other.count) {
+        other.count = 0;
+    }
+
+    /**
+     * @brief Destroys the objects of this arena and takes the blocks of another one, leaving it empty
+     * @param Arena&& other: arena to move
+     * @return Arena&: this arena
+     * @note Time Complexity: the one of clear(), Space Complexity: O(1)
+     */
+    Arena &operator=(Arena &&other) noexcept {
+        if (this != &other) {
+            clear();
+            blocks = std::move(other.blocks);
+            sorted = std::move(other.sorted);
+            count = other.count;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destroys every object and frees the blocks
+     * @note Time Complexity: O(b) if T is trivially destructible, b being the number of blocks, O(n) otherwise, Space Complexity: O(1)
+     */
+    ~Arena() {
+        clear();
+    }
+
+    /**
+     * @brief Constructs an object in the next free slot
+     * @param Args&&... args: arguments of a constructor of T
+     * @return T*: the object, valid until the arena is destroyed or cleared
+     * @note Time Complexity: O(1) amortized, O(b) when a block is added, Space Complexity: O(1) amortized
+     */
+    template<typename... Args>
+    T *create(Args &&...args) {
+        if (count == blocks.size() * BLOCK_SIZE) {
+            blocks.emplace_back(new Block);
+            Stats::add(STAT_ALLOCATIONS, 1);
+            const T *start = reinterpret_cast<const T *>(blocks.back()->slots);
+            auto at = std::upper_bound(sorted.begin(), sorted.end(), std::make_pair(start, blocks.size() - 1),
+                                       [](const std::pair<const T *, size_t> &a, const std::pair<const T *, size_t> &b) {
+                                           return std::less<const T *>()(a.first, b.first);
+                                       });
+            sorted.insert(at, std::make_pair(start, blocks.size() - 1));
+        }
+        T *slot = reinterpret_cast<T *>(&blocks[count / BLOCK_SIZE]->slots[count % BLOCK_SIZE]);
+        new(slot) T(std::forward<Args>(args)...);
+        count++;
+        return slot;
+    }
+
+    /**
+     * @brief Returns the number of objects created
+     * @return size_t: number of objects
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Returns an object by its index
+     * @param size_t i: index, smaller than size()
+     * @return T*: the i-th object created
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    T *operator[](size_t i) const {
+        return reinterpret_cast<T *>(&blocks[i / BLOCK_SIZE]->slots[i % BLOCK_SIZE]);
+    }
+
+    /**
+     * @brief Returns the index of an object of this arena
+     * @param const T* object: object created by this arena
+     * @return size_t: its index, such that (*this)[index] == object
+     * @note Time Complexity: O(log b), b being the number of blocks, Space Complexity: O(1)
+     */
+    size_t indexOf(const T *object) const {
+        auto after = std::upper_bound(sorted.begin(), sorted.end(), object,
+                                      [](const T *o, const std::pair<const T *, size_t> &block) {
+                                          return std::less<const T *>()(o, block.first);
+                                      });
+        const std::pair<const T *, size_t> &block = *(after - 1);
+        return block.second * BLOCK_SIZE + (object - block.first);
+    }
+
+    /**
+     * @brief Destroys every object and frees the blocks
+     * @return void
+     * @note Time Complexity: O(b) if T is trivially destructible, b being the number of blocks, O(n) otherwise, Space Complexity: O(1)
+     */
+    void clear() {
+        if (!std::is_trivially_destructible<T>::value)
+            for (size_t i = count; i > 0; i--)
+                (*this)[i - 1]->~T();
+        blocks.clear();
+        sorted.clear();
+        count = 0;
+    }
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,100 @@
+/**
+ * @file Components.hpp
+ * @brief Declaration of class Components
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include <vector>
+#include "Macros.hpp"
+#include "ResidualGraph.hpp"
+
+//! Weakly connected components of a residual graph, leaving the super source and the super sink out
+//! Water never goes from a component to another, so the maximum flow of each one can be calculated on its own,
+//! on a copy of its arcs, and the components can be solved at the same time
+class Components {
+private:
+    //! Arrays of one component, with its own super source and super sink
+    struct Part {
+        ResidualGraph graph;                                /*!< Arcs of the component and of the source and the sink into it */
+        std::vector<unsigned> arcs;                         /*!< Arc of the whole of each arc of the part */
+        std::vector<unsigned> vertexes;                     /*!< Vertexes of the component, in increasing order */
+    };
+
+    std::vector<Part> parts;                                /*!< Every component, in the order of their smallest vertex */
+    std::vector<unsigned> component;                        /*!< Component of each vertex, NONE for the source and the sink */
+
+public:
+    static const unsigned NONE = ~0u;                       /*!< Component of the source and the sink */
+
+    /**
+     * @brief Splits the vertexes of a residual graph into weakly connected components and builds the arrays of each one
+     * @param const ResidualGraph& r: whole residual graph
+     * @return void
+     * @note Cut arcs still connect their vertexes, so the components only change when the arrays are rebuilt
+     * @note Time Complexity: O(V + E * α(V)), Space Complexity: O(V + E)
+     */
+    void build(const ResidualGraph &r);
+
+    /**
+     * @brief Returns the number of components
+     * @return unsigned: number of components
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned count() const;
+
+    /**
+     * @brief Returns the component of a vertex
+     * @param unsigned v: index of the vertex in the whole
+     * @return unsigned: component, NONE for the source and the sink
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned componentOf(unsigned v) const;
+
+    /**
+     * @brief Returns the number of vertexes of a component
+     * @param unsigned c: component
+     * @return unsigned: number of vertexes, the source and the sink left out
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned size(unsigned c) const;
+
+    /**
+     * @brief Creates an empty state for every component, for a worker to reuse in solve()
+     * @return std::vector<FlowState>: state of each component
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    std::vector<ResidualGraph::FlowState> newStates() const;
+
+    /**
+     * @brief Calculates the maximum flow of one component, starting from its current flow, and writes it back to the whole
+     * @param const ResidualGraph& r: whole residual graph, the one given to build()
+     * @param FlowState& s: flow of the whole
+     * @param unsigned c: component
+     * @param max_flow_algorithm algorithm: algorithm
+     * @param std::vector<FlowState>& scratch: states from newStates(), owned by the calling thread and overwritten
+     * @return unsigned: number of BFSs/DFSs of the algorithm
+     * @note Time Complexity: the one of the algorithm on the component, Space Complexity: O(1)
+     */
+    unsigned solve(const ResidualGraph &r, ResidualGraph::FlowState &s, unsigned c, max_flow_algorithm algorithm,
+                   std::vector<ResidualGraph::FlowState> &scratch) const;
+
+    /**
+     * @brief Calculates the maximum flow of some components at the same time, and writes them back to the whole
+     * @param const ResidualGraph& r: whole residual graph, the one given to build()
+     * @param FlowState& s: flow of the whole
+     * @param const std::vector<bool>& which: whether each component has to be solved
+     * @param max_flow_algorithm algorithm: algorithm
+     * @param unsigned threads: number of threads (0 uses one per core)
+     * @return unsigned: number of BFSs/DFSs of the algorithm, added over the components
+     * @note Each component is solved on its own copy of the flow; the copies are written back in order, so the journal of s stays consistent
+     * @note Time Complexity: the one of the algorithm on the largest component, plus O(V + E), Space Complexity: O(V + E)
+     */
+    unsigned solve(const ResidualGraph &r, ResidualGraph::FlowState &s, const std::vector<bool> &which,
+                   max_flow_algorithm algorithm, unsigned threads) const;
+};
+
+#endif // COMPONENTS_HPP
@@ -10,6 +10,7 @@
 
 class Vertex;
 
+#include "Macros.hpp"
 #include "Vertex.hpp"
 
 //! Pipes
@@ -17,34 +18,45 @@ class Edge {
 private:
     Vertex *orig = nullptr;                       /*!< Origin of the edge */
     Vertex *dest = nullptr;                       /*!< Destination of the edge */
-    double weight = 0;                            /*!< Weight of the edge (can also be taken as capacity) */
-    double flow = 0;                              /*!< Current flow passing through the edge*/
+    Capacity weight = 0;                          /*!< Weight of the edge (can also be taken as capacity) */
+    Capacity flow = 0;                            /*!< Current flow passing through the edge*/
+    unsigned index = 0;                           /*!< Dense index given by its Graph, in creation order */
+
+    friend class Graph;
 
 public:
     /** 
      * @brief Constructor taking an origin, a destination and a Weight
      * @param Vertex* orig: origin
      * @param Vertex* dest: destination
-     * @param double w: capacity of the edge
+     * @param Capacity w: capacity of the edge
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */ 
-    Edge(Vertex *orig, Vertex *dest, double w);   
+    Edge(Vertex *orig, Vertex *dest, Capacity w);   
 
     /** 
      * @brief Returns the flow of the edge
-     * @return double: the flow of the edge
+     * @return Capacity: the flow of the edge
      * @note Does not change attributes
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    double getFlow() const;
+    Capacity getFlow() const;
 
     /**
      * @brief Return the capacity of the edge
-     * @return double: the capacity of the edge
+     * @return Capacity: the capacity of the edge
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Capacity getWeight() const;
+
+    /**
+     * @brief Returns the dense index given by the Graph that created the edge
+     * @return unsigned: index, smaller than Graph::getEdgeIndexCount()
      * @note Does not change attributes
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    double getWeight() const;
+    unsigned getIndex() const;
 
     /** 
      * @brief Return the origin of the edge
@@ -64,11 +76,20 @@ public:
 
     /** 
      * @brief Changes the value of the flow
-     * @param double flow: the updated flow of the edge
+     * @param Capacity flow: the updated flow of the edge
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void setFlow(Capacity flow);
+
+    /** 
+     * @brief Changes the capacity of the edge
+     * @param Capacity weight: the new capacity of the edge
      * @return void
+     * @note The residual graph of the network only sees it once rebuilt
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    void setFlow(double flow);
+    void setWeight(Capacity weight);
 };
 
 #endif // EDGE_HPP
@@ -0,0 +1,123 @@
+/**
+ * @file FlowState.hpp
+ * @brief Declaration of class FlowState
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef FLOW_STATE_HPP
+#define FLOW_STATE_HPP
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "Macros.hpp"
+
+template<typename Cap>
+class BasicResidualGraph;
+
+//! Flow of every arc of a ResidualGraph, plus the scratch arrays of its algorithms
+//! Cap is the type of the flows, see BasicResidualGraph
+template<typename Cap>
+class BasicFlowState {
+private:
+    std::vector<Cap> flow;                      /*!< Flow of each arc, indexed like the arcs of the ResidualGraph */
+    std::vector<unsigned char> removed;         /*!< Whether each arc was cut, its capacity is then taken as 0 */
+
+    std::vector<unsigned> parent;               /*!< Auxiliary field: arc used to reach each vertex */
+    std::vector<unsigned> visited;              /*!< Auxiliary field: stamp of the last search that reached each vertex */
+    std::vector<unsigned> queue;                /*!< Auxiliary field: BFS queue / DFS stack */
+    unsigned stamp = 0;                         /*!< Stamp of the current search */
+
+    std::vector<std::pair<unsigned, Cap>> journal;      /*!< Arc and flow added by every push since the journal was turned on */
+    bool journaling = false;                            /*!< Whether pushes are written to the journal */
+
+    friend class BasicResidualGraph<Cap>;
+
+public:
+    /**
+     * @brief Default constructor
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    BasicFlowState() = default;
+
+    /**
+     * @brief Copy constructor
+     * @param const BasicFlowState& other: state to copy
+     * @note The journal is not copied: the copy is a new scenario, with nothing to undo
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    BasicFlowState(const BasicFlowState &other);
+
+    /**
+     * @brief Copy assignment, with the same rules as the copy constructor
+     * @param const BasicFlowState& other: state to copy
+     * @return BasicFlowState&: this state
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    BasicFlowState &operator=(const BasicFlowState &other);
+
+    BasicFlowState(BasicFlowState &&other) = default;
+    BasicFlowState &operator=(BasicFlowState &&other) = default;
+
+    /**
+     * @brief Returns the flow of an arc
+     * @param unsigned a: arc
+     * @return Cap: flow
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Cap getFlow(unsigned a) const;
+
+    /**
+     * @brief Returns the flow of every arc
+     * @return const std::vector<Cap>&: flow of each arc
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    const std::vector<Cap> &getFlows() const;
+
+    /**
+     * @brief Replaces the flow of every arc, e.g. by a vector saved with getFlows()
+     * @param const std::vector<Cap>& flows: flow of each arc
+     * @return void
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    void setFlows(const std::vector<Cap> &flows);
+
+    /**
+     * @brief Returns whether an arc was cut
+     * @param unsigned a: arc
+     * @return bool: true if the arc was cut
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    bool isRemoved(unsigned a) const;
+
+    /**
+     * @brief Returns the cut flags of every arc
+     * @return const std::vector<unsigned char>&: whether each arc was cut
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    const std::vector<unsigned char> &getRemoved() const;
+
+    /**
+     * @brief Turns the journal of pushes on or off, emptying it when turned off
+     * @param bool on: whether to write every push to the journal
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void setJournaling(bool on);
+
+    /**
+     * @brief Returns the number of pushes in the journal, to roll back to later with ResidualGraph::rollback()
+     * @return size_t: size of the journal
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    size_t journalSize() const;
+};
+
+typedef BasicFlowState<Capacity> FlowState;    /*!< State of the flows of the network, with the capacity type it was compiled with */
+
+#endif // FLOW_STATE_HPP
@@ -16,22 +16,181 @@
 #include <cfloat>
 #include "Macros.hpp"
 #include "Vertex.hpp"
+#include "Arena.hpp"
+#include "ResidualGraph.hpp"
+#include "PathIndex.hpp"
+#include "Components.hpp"
+
+//! Pipe or Pumping Station that can fail in Graph::kFailures(), exactly one of the pointers is set
+struct FailurePoint {
+    Edge *pipe;                                                     /*!< Pipe, or nullptr */
+    Vertex *station;                                                /*!< Pumping Station (any location in Graph::evaluateRemovals()), or nullptr */
+};
+
+//! Result of one scenario evaluated by Graph::evaluateRemovals()
+struct RemovalReport {
+    std::vector<std::pair<Vertex *, Capacity>> cities;              /*!< Cities left whose water changes, and the water reaching them after the removals */
+    std::vector<std::pair<Vertex *, Capacity>> reservoirs;          /*!< Reservoirs left whose delivery changes, and their delivery after the removals */
+    Capacity flow = 0;                                              /*!< Maximum flow after the removals */
+};
+
+//! Combination of failures and the water it takes from a City
+struct FailureScenario {
+    std::vector<unsigned> members;                                  /*!< Indexes of the failing points, in increasing order */
+    Capacity deficit;                                               /*!< Water that stops reaching the City */
+};
+
+//! Result of Graph::kFailures()
+struct FailureReport {
+    std::vector<FailurePoint> points;                               /*!< Pumping Stations and Pipes that can fail */
+    std::unordered_map<Vertex *, std::vector<FailureScenario>> ranking; /*!< Most damaging combinations of each City, worst first */
+    unsigned long evaluated = 0;                                    /*!< Combinations whose maximum flow was calculated */
+    unsigned long skipped = 0;                                      /*!< Combinations whose last member carried no flow once the others failed */
+};
+
+//! Result of Graph::simulateFailures()
+struct ReliabilityReport {
+    std::unordered_map<Vertex *, double> expected;                  /*!< Mean water missing in each City */
+    std::unordered_map<Vertex *, double> percentile;                /*!< Water missing in each City at the given percentile of the samples */
+    double expectedTotal = 0;                                       /*!< Mean water missing in the whole network */
+    double percentileTotal = 0;                                     /*!< Water missing in the whole network at the given percentile */
+    double failedPipes = 0;                                         /*!< Mean number of pipes failed per sample */
+};
+
+//! Result of Graph::estimateFailure()
+struct FailureEstimate {
+    std::unordered_map<Vertex *, Capacity> deficit;                 /*!< Flow of the cut paths ending in each affected City, what it loses if nothing is rerouted */
+    Capacity total = 0;                                             /*!< Flow of every cut path, the most the maximum flow can lose */
+    unsigned paths = 0;                                             /*!< Number of cut paths */
+};
+
+//! Saturated pipes of the minimum cut that feed the same region, and the cities of that region they limit
+struct Bottleneck {
+    std::vector<Edge *> pipes;                                      /*!< Saturated pipes into the region; the edge from the Source for a Reservoir at its maximum delivery */
+    std::vector<Vertex *> cities;                                   /*!< Cities of the region that miss water, by type ID */
+    Capacity capacity = 0;                                          /*!< Capacity of the pipes, the most water the region can get */
+    Capacity missing = 0;                                           /*!< Water the cities miss */
+};
+
+//! Result of Graph::balanceFlow()
+struct BalanceReport {
+    double costBefore = 0;                                          /*!< Utilization cost (flow² / capacity added over the pipes) before */
+    double costAfter = 0;                                           /*!< Utilization cost after */
+    unsigned augmentations = 0;                                     /*!< Pushes that moved the flow, each through one arc */
+};
+
+//! Kind of change made by Graph::applyUpgrade()
+enum upgrade_type {
+    UPGRADE_PIPE,   // Raises the capacity of a pipe
+    ADD_PIPE,       // Adds a pipe between two locations
+    ADD_RESERVOIR   // Adds a reservoir with a pipe to a location
+};
+
+//! Change to the network that can be applied, or evaluated with others by Graph::evaluateUpgrades()
+struct Upgrade {
+    upgrade_type type;                                              /*!< Kind of change */
+    Vertex *orig;                                                   /*!< Origin of the pipe, nullptr for ADD_RESERVOIR (the new reservoir) */
+    Vertex *dest;                                                   /*!< Destination of the pipe */
+    Capacity capacity;                                              /*!< New capacity of the pipe */
+    unsigned reservoir;                                             /*!< ADD_RESERVOIR: type ID of the new reservoir */
+    Capacity delivery;                                              /*!< ADD_RESERVOIR: maximum delivery of the new reservoir */
+};
+
+//! Result of Graph::evaluateUpgrades()
+struct UpgradeReport {
+    bool applied = false;                                           /*!< Whether the change could be made */
+    std::unordered_map<Vertex *, Capacity> gain;                    /*!< Water gained by each City that gets more */
+    Capacity total = 0;                                             /*!< Water gained by the whole network */
+};
 
 //! Water Network
 class Graph {
 private:
-    Vertex *source = new Vertex(SOURCE, 0, "", "", "", 0);          /*!< Connected to all Reservoirs */
-    Vertex *sink = new Vertex(SINK, 0, "", "", "", 0);              /*!< All cities are connected to this Vertex */
+    Arena<Vertex> vertexArena;                                      /*!< Every Vertex of the graph, removed ones included */
+    Arena<Edge> edgeArena;                                          /*!< Every Edge of the graph, removed ones included */
+    Arena<VertexInfo> infoArena;                                    /*!< Cold data of each Vertex, by Vertex::getIndex() */
+
+    Vertex *source = createVertex(SOURCE, 0, "", "", "", 0);        /*!< Connected to all Reservoirs, index 0 */
+    Vertex *sink = createVertex(SINK, 0, "", "", "", 0);            /*!< All cities are connected to this Vertex, index 1 */
 
     std::vector<Vertex *> vertexSet;                                /*!< Set of vertexes */
 
     std::unordered_map<unsigned int, Vertex *> cityVertexes;        /*!< Map to find cities easily */
     std::unordered_map<unsigned int, Vertex *> reservoirVertexes;   /*!< Map to find reservoirs easily */
     std::unordered_map<unsigned int, Vertex *> stationVertexes;     /*!< Map to find pumping stations easily */
+    std::vector<unsigned> codeIndexes[3];                           /*!< Index of the city, reservoir and station (node_type order) with each type ID, NO_INDEX if none */
 
     std::vector<Vertex *> removedVertexes;                          /*!< Vector to keep removed vertexes */
     std::vector<Edge *> removedEdges;                               /*!< Vector to keep remove edges */ 
+
+    mutable ResidualGraph residual;                                 /*!< Arrays used by the maximum flow algorithms */
+    mutable FlowState state;                                        /*!< Flow of the arrays, mirrored in the edges */
+    mutable bool residualUpToDate = false;                          /*!< Whether the arrays match the current vertexes and edges */
+    mutable PathIndex paths;                                        /*!< Decomposition of the flow into paths, built on demand */
+    mutable bool pathsUpToDate = false;                             /*!< Whether the paths belong to the current arrays */
+    mutable Components components;                                  /*!< Weakly connected components of the arrays */
+    mutable std::vector<bool> unsolved;                             /*!< Whether the flow of each component may not be maximum */
+
+    std::vector<bool> dependencyKnown;                              /*!< Whether the dependency vector of each city, by Vertex::getIndex(), belongs to the arrays below */
+    std::vector<Capacity> dependencyFlows;                          /*!< Flow of every arc when the known dependency vectors were calculated */
+    std::vector<unsigned char> dependencyRemoved;                   /*!< Cut arcs when they were calculated */
+    std::vector<Capacity> dependencyCapacities;                     /*!< Capacity of every arc when they were calculated */
+
+    //! What has to be kept to roll the network back to a checkpoint
+    struct Checkpoint {
+        size_t journal;                                             /*!< Size of the journal of the state */
+        size_t vertexes;                                            /*!< Number of removed vertexes */
+        size_t edges;                                               /*!< Number of removed edges */
+        std::vector<bool> unsolved;                                 /*!< Components whose flow may not have been maximum */
+    };
+    std::vector<Checkpoint> checkpoints;                            /*!< Stack of checkpoints, the newest at the back */
+
+    max_flow_algorithm algorithm = EDMONDS_KARP;                    /*!< Algorithm used by maxFlow() */
+    unsigned threads = 1;                                           /*!< Threads used by the failure analyses, 0 for one per core */
+
+    /**
+     * @brief Inserts a Vertex in the vertex set and in the map of its type
+     * @param Vertex* v: the Vertex to insert
+     * @return bool: true if successful
+     * @note Auxiliary function of addVertex() and rollback(), does not touch the residual graph
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    bool insertVertex(Vertex *v);
+
+    /**
+     * @brief Checks whether the flow of every component is maximum for the current arrays
+     * @return bool: false if the arrays are out of date or a component is left to be solved
+     * @note Auxiliary function of the additions
+     * @note Time Complexity: O(c), c being the number of components, Space Complexity: O(1)
+     */
+    bool isSolved() const;
+
+    /**
+     * @brief Checks whether the flow, the cut arcs and the capacities are the ones the cached dependency vectors were calculated with
+     * @return bool: true if the known dependency vectors are still valid
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    bool dependencyCacheValid() const;
+
+    /**
+     * @brief Forgets the cached dependency vectors if the flow changed since they were calculated, and keeps the current flow as the new key
+     * @return void
+     * @note Time Complexity: O(V + E), Space Complexity: O(E)
+     */
+    void validateDependencyCache();
+
+    /**
+     * @brief Rebuilds the arrays after an addition, keeping the flow of the edges, and leaves the component of a vertex to be solved again
+     * @param Vertex* v: vertex the addition touched, nullptr if no component has to be solved again
+     * @param bool solved: isSolved() before the addition; if false, every component is left to be solved again
+     * @return void
+     * @note Auxiliary function of the additions
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    void rebuildAround(Vertex *v, bool solved);
 public:
+    static const unsigned NO_INDEX = ~0u;                           /*!< Marks a type ID without vertex */
+
     /**
      * @brief Default constructor
      * @note Time Complexity: O(1), Space Complexity: O(1)
@@ -41,26 +200,87 @@ public:
     /**
      * @brief Deep copy constructor
      * @param const Graph& other: graph to copy
-     * @note Time Complexity: O(1), Space Complexity: O(1)
+     * @note The arenas are copied in order, so every Vertex and Edge keeps its index, and the pointers are then translated by index
+     * @note The vertex set, the adjacency and incoming vectors and the removed vertexes and edges keep their order
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
      */
     Graph(const Graph &other);
 
+    Graph &operator=(const Graph &) = delete;
+
+    /**
+     * @brief Creates a Vertex in the arena of the graph, without adding it
+     * @param node_type type: specifies the type of the Vertex
+     * @param unsigned int id: unique identifier
+     * @param const std::string reservoir = "": if a reservoir, its name
+     * @param const std::string municipality = "": if a reservoir, its municipality
+     * @param const std::string city = "": if a city, its name
+     * @param unsigned int population = 0: if a city, its population
+     * @return Vertex*: the Vertex, owned by the graph, with the next dense index
+     * @note The strings and the population go to a VertexInfo with the same index
+     * @note Time Complexity: O(1) amortized, Space Complexity: O(1)
+     */
+    Vertex *createVertex(node_type type, unsigned int id, const std::string reservoir = "",
+                         const std::string municipality = "", const std::string city = "", unsigned int population = 0);
+
+    /**
+     * @brief Creates an Edge in the arena of the graph, without linking it to its vertexes
+     * @param Vertex* orig: origin
+     * @param Vertex* dest: destination
+     * @param Capacity w: capacity
+     * @return Edge*: the Edge, owned by the graph, with the next dense index
+     * @note Edges created one after the other are contiguous in memory
+     * @note Time Complexity: O(1) amortized, Space Complexity: O(1)
+     */
+    Edge *createEdge(Vertex *orig, Vertex *dest, Capacity w);
+
     /**
      * @brief Returns a Vertex if present. Uses an ID to search
-     * @param unsigned int id: the ID of the Vertex to look for
+     * @param unsigned int id: the ID of the Vertex to look for (type ID * 10 + 1, 2 or 3)
      * @return Vertex*: nullptr if not found
      * @note Does not change attributes
-     * @note Time Complexity: O(V), Space Complexity: O(1)
+     * @note Time Complexity: O(1), Space Complexity: O(1)
      */
     Vertex *findVertex(unsigned int id) const;
 
     /**
-     * @brief Returns a Vertex if present. Uses a code and unordered maps to search
+     * @brief Returns a Vertex if present. Uses a code (C_1, R_1, PS_1) to search
      * @param std::string& code: the code of the Vertex
      * @return Vertex* : nullptr if not found
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    Vertex *findVertex(const std::string &code);
+    Vertex *findVertex(const std::string &code) const;
+
+    /**
+     * @brief Returns a Vertex if present. Uses its type and type ID to search
+     * @param node_type type: CITY, RESERVOIR or STATION
+     * @param unsigned int typeId: number of its code
+     * @return Vertex*: nullptr if not found
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Vertex *findVertex(node_type type, unsigned int typeId) const;
+
+    /**
+     * @brief Returns the Vertex with a dense index
+     * @param unsigned index: index, smaller than getIndexCount()
+     * @return Vertex*: the Vertex, which may have been removed
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Vertex *getVertex(unsigned index) const;
+
+    /**
+     * @brief Returns the number of vertex indexes given, removed vertexes, the Source and the Sink included
+     * @return unsigned: number of indexes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getIndexCount() const;
+
+    /**
+     * @brief Returns the number of edge indexes given, removed edges included
+     * @return unsigned: number of indexes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getEdgeIndexCount() const;
 
     /**
      * @brief Returns an Edge if present
@@ -69,11 +289,11 @@ public:
      * @return Edge*: nullptr if not found
      * @note Time Complexity: O(n), n being the number of adjacent edges of src, Space Complexity: O(1)
      */
-    Edge *findEdge(Vertex *src, Vertex *dst);
+    Edge *findEdge(Vertex *src, Vertex *dst) const;
 
     /**
      * @brief Adds a Vertex
-     * @param Vertex* v: the Vertex to add
+     * @param Vertex* v: the Vertex to add, made by createVertex()
      * @return bool: true if successful
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
@@ -85,31 +305,61 @@ public:
      * @param (Optional) unsigned int* iterations = nullptr: number of iterations
      * @return bool: true if successful
      * @note Auxiliary function
+     * @note Its arcs are cut in the residual graph, which is not rebuilt
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
     bool removeVertex(unsigned int id, unsigned *iterations = nullptr);
 
+    /**
+     * @brief Removes a Vertex
+     * @param Vertex* v: the Vertex to remove
+     * @param (Optional) unsigned int* iterations = nullptr: number of iterations
+     * @return bool: true if successful
+     * @note Its arcs are cut in the residual graph, which is not rebuilt
+     * @note Only its component is left to be solved again by maxFlow()
+     * @note Time Complexity: O(V + E), Space Complexity: O(1)
+     */
+    bool removeVertex(Vertex *v, unsigned *iterations = nullptr);
+
     /**
      * @brief Reduces the flow from a vertex to another by an amount smaller or equal to the value provided.
      * @param Vertex* src: origin
      * @param Vertex* dst: destination
-     * @param double limit: the maximum flow that can be reduced
+     * @param Capacity limit: the maximum flow that can be reduced
      * @return unsigned : number of BFSs
      * @note The network's flow may become invalid if src != getSource() && dst != getSink()
      * @note Does not change attributes
      * @note Time Complexity: O(V * E²), Space Complexity: O(V)
      */
-    unsigned reduceFlow(Vertex *src, Vertex *dst, double limit) const;
+    unsigned reduceFlow(Vertex *src, Vertex *dst, Capacity limit) const;
 
     /**
      * @brief Adds an Edge
      * @param unsigned int source: ID of origin
      * @param unsigned int dest: ID of destination
-     * @param double w: capacity of edge
+     * @param Capacity w: capacity of edge
      * @return bool: true if successful
      * @note Time Complexity: O(V + E), Space Complexity: O(1)
      */
-    Edge * addEdge(unsigned int source, unsigned int dest, double w);
+    Edge * addEdge(unsigned int source, unsigned int dest, Capacity w);
+
+    /**
+     * @brief Creates an Edge and links it to its vertexes
+     * @param Vertex* orig: origin
+     * @param Vertex* dest: destination
+     * @param Capacity w: capacity of edge
+     * @return Edge*: the new Edge
+     * @note Time Complexity: O(1) amortized, Space Complexity: O(1)
+     */
+    Edge *addEdge(Vertex *orig, Vertex *dest, Capacity w);
+
+    /**
+     * @brief Links an Edge made by createEdge() to the end of the outgoing edges of its origin and the incoming edges of its destination
+     * @param Edge* e: edge
+     * @return void
+     * @note Time Complexity: O(1) amortized, Space Complexity: O(1)
+     */
+    void addEdge(Edge *e);
 
     /**
      * @brief Removes an Edge
@@ -118,10 +368,67 @@ public:
      * @param (Optional) unsigned* iterations = nullptr: number of iterations
      * @return bool: true if successful
      * @note Auxiliary functino
+     * @note Its arc is cut in the residual graph, which is not rebuilt
+     * @note Only its component is left to be solved again by maxFlow()
      * @note Time Complexity: O(n) n being the number of adjacent edges of src, Space Complexity: O(1)
      */
     bool removeEdge(Vertex *src, Vertex *dest, unsigned *iterations = nullptr);
 
+    /**
+     * @brief Raises the capacity of a pipe, keeping the flow
+     * @param Edge* e: pipe that is not removed
+     * @param Capacity capacity: new capacity, not lower than the current one
+     * @return bool: false if the pipe is removed or the capacity is lower
+     * @note The current flow stays valid, so maxFlow() only augments through the new capacity, in the component of the pipe
+     * @note Discards every checkpoint
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    bool upgradePipe(Edge *e, Capacity capacity);
+
+    /**
+     * @brief Adds a pipe between two locations, keeping the flow
+     * @param Vertex* orig: origin, a City, Reservoir or Pumping Station that is not removed
+     * @param Vertex* dest: destination, a City, Reservoir or Pumping Station that is not removed
+     * @param Capacity capacity: capacity of the pipe
+     * @return Edge*: the new pipe, nullptr if there already is one from orig to dest or orig == dest
+     * @note maxFlow() only augments through the new pipe, in the component it ends up in
+     * @note Discards every checkpoint
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    Edge *addPipe(Vertex *orig, Vertex *dest, Capacity capacity);
+
+    /**
+     * @brief Adds a Reservoir, fed by the Source, without pipes
+     * @param unsigned typeId: number of its code, not used by another Reservoir, removed ones included
+     * @param const std::string& name: name of the reservoir
+     * @param Capacity delivery: maximum delivery
+     * @return Vertex*: the new Reservoir, nullptr if the code is taken
+     * @note It only delivers water once addPipe() links it to the network
+     * @note Discards every checkpoint
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    Vertex *addReservoir(unsigned typeId, const std::string &name, Capacity delivery);
+
+    /**
+     * @brief Makes a change to the network, keeping the flow
+     * @param const Upgrade& upgrade: change, whose vertexes belong to this graph
+     * @return bool: false if the change cannot be made
+     * @note Calls upgradePipe(), addPipe() or addReservoir() and addPipe(); maxFlow() has to be called afterwards
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    bool applyUpgrade(const Upgrade &upgrade);
+
+    /**
+     * @brief Evaluates many candidate changes, each one on its own over the current network
+     * @param const std::vector<Upgrade>& candidates: changes, whose vertexes belong to this graph
+     * @return std::vector<UpgradeReport>: water gained by each City with each change, in the order of the candidates
+     * @note The arcs of every candidate are added, cut, to one residual graph (an upgrade is a parallel arc with the extra capacity);
+     * each candidate brings its own back on the private FlowState of a worker, whose maximum flow is calculated from the current one; the current flow should be maximum
+     * @note The candidates are handed out to getThreads() workers; the result is the same for any number of threads
+     * @note Time Complexity: O(V + E + n * (V + E + F)), n being the number of candidates and F the cost of a maximum flow, Space Complexity: O(threads * (V + E + n) + n * C)
+     */
+    std::vector<UpgradeReport> evaluateUpgrades(const std::vector<Upgrade> &candidates) const;
+
     /**
      * @brief Returns the vector of Vertexes
      * @return const std::vector<Vertex*>&: vector of vertexes
@@ -148,19 +455,19 @@ public:
 
     /**
      * @brief Returns the total flow
-     * @return double: total flow
+     * @return Capacity: total flow
      * @note Does not change attributes
      * @note Time Complexity: O(V + E), Space Complexity: O(1)
      */
-    double getFlow() const;
+    Capacity getFlow() const;
 
     /**
      * @brief Returns the flow coming out of the Source
-     * @return double: flow coming from Source
+     * @return Capacity: flow coming from Source
      * @note Does not change attributes
      * @note Time Complexity: O(V + E), Space Complexity: O(1)
      */
-    double getFlowFromSource() const;
+    Capacity getFlowFromSource() const;
 
     /**
      * @brief Returns the unordered map of cities
@@ -203,44 +510,160 @@ public:
     const std::vector<Edge *> &getRemovedEdges() const;
 
     /**
-     * @brief Sets all vertex as unvisited
-     * @return void
+     * @brief Returns the residual graph, rebuilding it if the vertexes or edges changed since it was built
+     * @return const ResidualGraph&: residual graph, whose state is loaded with the current flow of every Edge
+     * @note The flow computed on the state is only visible in the edges after ResidualGraph::store()
+     * @note Time Complexity: O(E) if up to date, O(V + E) otherwise, Space Complexity: O(V + E)
+     */
+    const ResidualGraph &getResidual() const;
+
+    /**
+     * @brief Returns a copy of the flow of the current scenario, e.g. to compare it with the flow after a removal
+     * @return FlowState: flow and cut arcs of the residual graph
+     * @note Removals only cut arcs, so the copy can be read with getEdgeFlow() until restore() or an addition
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    FlowState getState() const;
+
+    /**
+     * @brief Returns the flow of an Edge in a scenario taken with getState()
+     * @param const FlowState& scenario: flow
+     * @param const Edge* e: edge, removed or not
+     * @return Capacity: flow of the edge in that scenario
      * @note Does not change attributes
-     * @note Time Complexity: O(V), Space Complexity: O(1)
+     * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    void setAllVisitedFalse() const;
+    Capacity getEdgeFlow(const FlowState &scenario, const Edge *e) const;
 
     /**
-     * @brief Calculates the maximum flow
-     * @return unsigned: maximum flow
-     * @note Time Complexity: O(V * E²), Space Complexity: O(1)
+     * @brief Returns the decomposition of the current flow into paths, rebuilding it if the flow changed since it was built
+     * @return const PathIndex&: paths over the arcs of getResidual()
+     * @note Time Complexity: O(E) if up to date, the one of PathIndex::build() otherwise, Space Complexity: O(P * V + E)
+     */
+    const PathIndex &getPathIndex() const;
+
+    /**
+     * @brief Estimates, without calculating any flow, the water the removal of a Vertex takes from each City
+     * @param Vertex* v: City, Reservoir or Pumping Station that is not removed
+     * @return FailureEstimate: paths through the vertex, by City
+     * @note Every path through v stops and the others still form a valid flow, so the maximum flow never loses more than the total
+     * @note A repair may still move water between cities, so the exact loss of a City can differ from its cut paths
+     * @note Time Complexity: O(E) to check the index, plus O(k * log k), k being the number of paths through v, Space Complexity: O(k)
+     */
+    FailureEstimate estimateFailure(Vertex *v) const;
+
+    /**
+     * @brief Estimates, without calculating any flow, the water the removal of an Edge takes from each City
+     * @param Edge* e: pipe that is not removed
+     * @return FailureEstimate: paths through the pipe, by City
+     * @note Time Complexity: O(E) to check the index, plus O(k * log k), k being the number of paths through e, Space Complexity: O(k)
+     */
+    FailureEstimate estimateFailure(Edge *e) const;
+
+    /**
+     * @brief Finds the bottlenecks of the current maximum flow from its minimum cut
+     * @return std::vector<Bottleneck>: groups of saturated pipes and the cities behind them, the ones missing the most water first
+     * @note One BFS from the Source in the residual graph splits the vertexes; the vertexes it does not reach are grouped in regions joined by pipes
+     * @note Every City missing water is behind the cut, so each one is in exactly one group; cities whose demand is met are left out
+     * @note The flow has to be maximum, e.g. after maxFlow()
+     * @note Time Complexity: O(V + E * α(V)), Space Complexity: O(V + E)
+     */
+    std::vector<Bottleneck> bottlenecks() const;
+
+    /**
+     * @brief Spreads the current flow over the pipes as evenly as their capacities allow, keeping the water reaching each City
+     * @return BalanceReport: utilization cost before and after, and the augmentations
+     * @note Minimizes flow² / capacity added over the pipes, a convex cost whose marginal is twice the flow / capacity ratio of each pipe
+     * @note The total flow does not change, so a maximum flow stays maximum; the reservoirs may share the water differently
+     * @note Runs ResidualGraph::balance() and writes the result back to the edges
+     * @note Time Complexity: the one of ResidualGraph::balance(), Space Complexity: O(V + E)
+     */
+    BalanceReport balanceFlow();
+
+    /**
+     * @brief Calculates the maximum flow, starting from the current flow
+     * @return unsigned: number of BFSs
+     * @note Runs on the residual graph and writes the result back to the edges
+     * @note Time Complexity: O(V * E²), Space Complexity: O(V + E)
      */
     unsigned edmondsKarp();
 
     /**
-     * @brief Computes augmenting paths
-     * @param Vertex* v: current Vertex
-     * @param std::vector<Edge*>& toIncreaseFlow: set of edges whose flow must be increased
-     * @param std::vector<Edge*>& toDecreaseFlow: set of edges whose flow must be decreased
-     * @param double& flow: flow of the path
-     * @param bool& found: if a path to the Sink was found
+     * @brief Calculates maximum flow from scratch
+     * @param (Optional) unsigned* iterations = nullptr: number of DFSs
+     * @return Capacity: maximum flow
+     * @note Runs on the residual graph and writes the result back to the edges
+     * @note Time Complexity: O(E * f), Space Complexity: O(V + E)
+     */
+    Capacity fordFulkerson(unsigned *iterations = nullptr);
+
+    /**
+     * @brief Calculates the maximum flow with Dinic, starting from the current flow
+     * @return unsigned: number of BFSs (phases)
+     * @note Runs on the residual graph and writes the result back to the edges
+     * @note Time Complexity: O(V² * E), Space Complexity: O(V + E)
+     */
+    unsigned dinic();
+
+    /**
+     * @brief Calculates the maximum flow with FIFO push-relabel, starting from the current flow
+     * @return unsigned: number of global relabellings (BFSs from the sink)
+     * @note Runs on the residual graph and writes a valid flow back to the edges
+     * @note Time Complexity: O(V³), Space Complexity: O(V + E)
+     */
+    unsigned pushRelabel();
+
+    /**
+     * @brief Calculates the maximum flow with the selected algorithm
+     * @return unsigned: number of BFSs/DFSs of the algorithm
+     * @note Ford-Fulkerson always starts from scratch, the others from the current flow
+     * @note Only the components changed since their last maximum flow are solved, each one on its own, on getThreads() threads
+     * @note Flows set directly on the edges are not noticed, resetFlow() has to be used instead
+     * @note Time Complexity: depends on the algorithm, on the largest changed component, Space Complexity: O(V + E)
+     */
+    unsigned maxFlow();
+
+    /**
+     * @brief Returns the weakly connected components of the network, the Source and the Sink left out
+     * @return const Components&: components of the arrays of getResidual()
+     * @note Time Complexity: the one of getResidual(), Space Complexity: O(V + E)
+     */
+    const Components &getComponents() const;
+
+    /**
+     * @brief Returns the algorithm used by maxFlow()
+     * @return max_flow_algorithm: algorithm
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    max_flow_algorithm getAlgorithm() const;
+
+    /**
+     * @brief Selects the algorithm used by maxFlow()
+     * @param max_flow_algorithm algorithm: algorithm
      * @return void
-     * @note Time Complexity: O(V * E), Space Complexity: O(V)
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void setAlgorithm(max_flow_algorithm algorithm);
+
+    /**
+     * @brief Converts the name of an algorithm ("edmonds_karp", "ford_fulkerson", "dinic" or "push_relabel")
+     * @param const std::string& name: name of the algorithm
+     * @param max_flow_algorithm& algorithm: where the algorithm is written
+     * @return bool: false if the name is unknown
+     * @note This function is static
+     * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    void recursiveAugmentingPath(
-        Vertex *v,
-        std::vector<Edge *> &toIncreaseFlow,
-        std::vector<Edge *> &toDecreaseFlow,
-        double &flow,
-        bool &found
-    );
+    static bool parseAlgorithm(const std::string &name, max_flow_algorithm &algorithm);
 
     /**
-     * @brief Calculates maximum flow
-     * @return double: maximum flow
-     * @note Time Complexity: O(V * E²), Space Complexity: O(1)
+     * @brief Returns the name of an algorithm, as accepted by parseAlgorithm()
+     * @param max_flow_algorithm algorithm: algorithm
+     * @return std::string: name of the algorithm
+     * @note This function is static
+     * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    double fordFulkerson();
+    static std::string algorithmName(max_flow_algorithm algorithm);
   
     /**
      * @brief Resets only the flow
@@ -250,7 +673,7 @@ public:
     void resetFlow();
 
     /**
-     * @brief Resets all attributes modified by maximum flow algorithms
+     * @brief Resets all attributes modified by maximum flow algorithms, which is only the flow
      * @return void
      * @note Time Complexity: O(V + E), Space Complexity: O(1)
      */
@@ -259,22 +682,145 @@ public:
     /**
      * @brief Restores all removed vertexes and edges
      * @return void
+     * @note Pipes and reservoirs added or upgraded are kept
+     * @note Discards every checkpoint
      * @note Time Complexity: O(V + E), Space Complexity: O(1)
      */
     void restore();
 
+    /**
+     * @brief Saves the current removals and flow, so that rollback() can go back to them
+     * @return unsigned: number of checkpoints, this one included
+     * @note From the first checkpoint on, every push of the maximum flow algorithms is journaled
+     * @note restore() and additions discard every checkpoint
+     * @note Time Complexity: O(E) for the first checkpoint, O(1) for the others, Space Complexity: O(1)
+     */
+    unsigned checkpoint();
+
+    /**
+     * @brief Goes back to the n-th newest checkpoint, discarding it and the newer ones
+     * @param (Optional) unsigned n = 1: number of checkpoints to discard
+     * @return bool: false if there are less than n checkpoints, or n is 0
+     * @note The removed vertexes and edges are put back at the end of the vectors they were in, and their arcs restored
+     * @note The flow is restored by undoing the journaled pushes, no maximum flow is calculated
+     * @note Time Complexity: O(n + E), n being the number of changes undone, Space Complexity: O(1)
+     */
+    bool rollback(unsigned n = 1);
+
+    /**
+     * @brief Returns the number of checkpoints
+     * @return unsigned: number of checkpoints
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getCheckpoints() const;
+
+    /**
+     * @brief Returns the number of threads used by the failure analyses
+     * @return unsigned: number of threads, 0 meaning one per core
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getThreads() const;
+
+    /**
+     * @brief Sets the number of threads used by the failure analyses
+     * @param unsigned threads: number of threads, 0 meaning one per core
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void setThreads(unsigned threads);
+
     /**
      * @brief Fills the dependency vector of every city
      * @return void
-     * @note Tries to remove every pipe and executes midway maximum flow algorithm
-     * @note Finds out which cities were affected by each pipe removal
-     * @note Time Complexity: O(V * E³), Space Complexity: O(1)
+     * @note Same as calculateDependency(cities) with every city; the server uses it to have every vector before answering queries
+     * @note Time Complexity: O(V * E³ / threads), Space Complexity: O(threads * (V + E) + P * V)
      */
     void calculateDependency();
 
+    /**
+     * @brief Fills the dependency vectors of some cities, for the current flow
+     * @param const std::vector<Vertex*>& cities: cities
+     * @return void
+     * @note Only the pipes on the flow paths into the cities (see getPathIndex()) are cut, one at a time, and the water of each
+     *       city is only compared for the pipes on its own paths; a pipe that carries none of its water is never in its vector
+     * @note Only a copy of the flow vector is kept: it is restored after each pipe, the graph is never copied
+     * @note The pipes are handed out to getThreads() workers, each with its own FlowState over the shared residual graph,
+     *       and only the component of the pipe is solved again after it is cut; the result is the same for any number of threads
+     * @note The vectors are cached until the flow, the cut arcs or the capacities change (any removal, restore, upgrade, balance, ...)
+     * @note Time Complexity: O(p * F / threads), p being the number of pipes on the paths and F the cost of a maximum flow on a component, Space Complexity: O(threads * (V + E) + P * V)
+     */
+    void calculateDependency(const std::vector<Vertex *> &cities);
+
+    /**
+     * @brief Returns the dependency vector of a city, calculating it first if it is not cached for the current flow
+     * @param Vertex* city: city
+     * @return const std::vector<std::pair<Edge*, Capacity>>&: pipes whose removal takes water from the city, and how much
+     * @note Time Complexity: O(E) if cached, the one of calculateDependency(cities) for one city otherwise, Space Complexity: O(E)
+     */
+    const std::vector<std::pair<Edge *, Capacity>> &getDependency(Vertex *city);
+
+    /**
+     * @brief Checks whether the dependency vector of a city is cached for the current flow
+     * @param const Vertex* city: city
+     * @return bool: true if Vertex::getDependency() can be read as it is
+     * @note Only reads the network once the arrays are up to date, so it can be called from several threads
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    bool isDependencyKnown(const Vertex *city) const;
+
+    /**
+     * @brief Declares the dependency vectors of some cities, filled from elsewhere (e.g. a snapshot), as calculated for the current flow
+     * @param const std::vector<Vertex*>& cities: cities
+     * @return void
+     * @note Forgets every other cached vector
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    void setDependencyKnown(const std::vector<Vertex *> &cities);
+
+    /**
+     * @brief Ranks, for every city, the combinations of k pipes or pumping stations failing at once that take the most water from it
+     * @param unsigned k: number of simultaneous failures
+     * @param unsigned top: length of the ranking of each city
+     * @return FailureReport: failure points, rankings and counters
+     * @note The combinations are explored depth-first, each one starting from the flow of the (k-1) combination it extends
+     * @note A combination whose last member carries no flow once the others failed is skipped: it takes as much water as them
+     * @note The first member of the combinations is handed out to getThreads() workers; the result is the same for any number of threads
+     * @note Ties are ranked by the indexes of the members
+     * @note The water each (k-1) combination takes is kept only for the cities it takes water from, so k = 3 fits in memory on large networks
+     * @note Time Complexity: O(P^k * (E + F)), P being the number of failure points and F the cost of a maximum flow, Space Complexity: O(threads * (k * (V + E) + C * top * k) + D),
+     * D being the pairs of a (k-1) combination and a city it takes water from
+     */
+    FailureReport kFailures(unsigned k, unsigned top) const;
+
+    /**
+     * @brief Calculates, for each scenario on its own, the water reaching each City and delivered by each Reservoir once the network is repaired
+     * @param const std::vector<std::vector<FailurePoint>>& scenarios: pipes and locations (of any type) removed together in each scenario
+     * @return std::vector<RemovalReport>: what changes in each scenario, in the same order, cities and reservoirs by type ID
+     * @note Nothing is removed: the arcs are cut on a copy of the flow, like removeVertex() and removeEdge() do, and only their components are solved again
+     * @note The scenarios are handed out to getThreads() workers, each with its own FlowState; the result is the same for any number of threads
+     * @note Time Complexity: O(n * (k + F)), n being the number of scenarios, k their size and F the cost of a maximum flow, Space Complexity: O(threads * (V + E) + n * (C + R))
+     */
+    std::vector<RemovalReport> evaluateRemovals(const std::vector<std::vector<FailurePoint>> &scenarios) const;
+
+    /**
+     * @brief Estimates the water missing in each city when every pipe fails independently with a given probability
+     * @param unsigned samples: number of random failure sets
+     * @param double probability: failure probability of each pipe
+     * @param double percentile: percentile of the deficit to report, between 0 and 1
+     * @param unsigned long seed: seed of the random numbers
+     * @return ReliabilityReport: expected and percentile deficits
+     * @note Each sample repairs the current maximum flow, like removeEdge() does, and then runs the selected algorithm from there
+     * @note Each sample has its own random stream, derived from the seed and its index, so the result is the same for any number of threads
+     * @note Time Complexity: O(samples * (E + F)), F being the cost of a maximum flow, Space Complexity: O(samples * C + threads * (V + E))
+     */
+    ReliabilityReport simulateFailures(unsigned samples, double probability, double percentile, unsigned long seed) const;
+
     /**
      * @brief Destroys everything
-     * @note Time Complexity: O(V + E), Space Complexity: O(1)
+     * @note The edges are freed a block at a time, without being visited; the vertexes still run their destructors
+     * @note Time Complexity: O(V), Space Complexity: O(1)
      */
     ~Graph();
 };
@@ -1,6 +1,6 @@
 /**
 * @file Macros.hpp
-* @brief Macros with colors and a numeric limit
+* @brief Macros with colors, the capacity type and a numeric limit
 * @author G17_5
 * @date 30/03/2024
 */
@@ -9,6 +9,7 @@
 #define MACROS_HPP
 
 #include <limits>
+#include <cstdint>
 
 // Colors
 #define BLACK       "\033[30m"
@@ -21,7 +22,16 @@
 #define WHITE       "\033[37m"
 #define ANSI_RESET  "\033[0m"
 
+// Type of the capacities and flows of the network
+// Exact 64-bit integers when compiled with -DINTEGER_CAPACITY (the capacities of the datasets are whole m³/s),
+// double otherwise, for datasets with fractional capacities
+#ifdef INTEGER_CAPACITY
+typedef int64_t Capacity;
+#else
+typedef double Capacity;
+#endif
+
 // Constants
-#define INF std::numeric_limits<double>::max()
+#define INF std::numeric_limits<Capacity>::max()
 
 #endif // MACROS_HPP
@@ -0,0 +1,67 @@
+/**
+ * @file MappedFile.hpp
+ * @brief Declaration of class MappedFile
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+//! Read-only memory mapping of a whole file, unmapped when destroyed
+class MappedFile {
+private:
+    const char *data = nullptr;                 /*!< First byte of the file, nullptr if it could not be mapped */
+    size_t length = 0;                          /*!< Size of the file */
+    bool open = false;                          /*!< Whether the file was found (an empty file is open but has no data) */
+
+public:
+    /**
+     * @brief Maps a file
+     * @param const std::string& file: name of the file
+     * @note Time Complexity: O(1), the pages are only read when accessed, Space Complexity: O(1)
+     */
+    explicit MappedFile(const std::string &file);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Unmaps the file
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Returns whether the file could be opened
+     * @return bool: true if the file exists and was mapped
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the first byte of the file
+     * @return const char*: start of the mapping, nullptr if the file is empty or not open
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    const char *begin() const;
+
+    /**
+     * @brief Returns the byte after the last one of the file
+     * @return const char*: end of the mapping
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    const char *end() const;
+
+    /**
+     * @brief Returns the size of the file
+     * @return size_t: number of bytes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    size_t size() const;
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,34 @@
+/**
+ * @file Parallel.hpp
+ * @brief Declaration of the helpers that spread independent tasks over threads
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <functional>
+
+/**
+ * @brief Runs job(worker, task) for every task in [0, tasks), handing the tasks out to a pool of threads
+ * @param unsigned tasks: number of tasks
+ * @param unsigned threads: number of threads (0 uses one per core)
+ * @param const std::function<void(unsigned, unsigned)>& job: called with the index of the worker and of the task
+ * @return void
+ * @note Each worker index is used by a single thread, so it can select state private to that thread
+ * @note With a single thread, the tasks run in order on the calling thread
+ * @note Time Complexity: O(tasks) calls of job, Space Complexity: O(threads)
+ */
+void parallelFor(unsigned tasks, unsigned threads, const std::function<void(unsigned, unsigned)> &job);
+
+/**
+ * @brief Returns the number of threads that parallelFor() will really use
+ * @param unsigned tasks: number of tasks
+ * @param unsigned threads: number of threads requested (0 uses one per core)
+ * @return unsigned: number of workers, between 1 and tasks
+ * @note Time Complexity: O(1), Space Complexity: O(1)
+ */
+unsigned workerCount(unsigned tasks, unsigned threads);
+
+#endif // PARALLEL_HPP
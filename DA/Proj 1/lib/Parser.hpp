@@ -15,15 +15,16 @@
 #include <iomanip>
 #include "Macros.hpp"
 #include "Graph.hpp"
+#include "MappedFile.hpp"
 
 /**
 * @brief Checks if a file with the given name exists
 * @param const std::string filename: name of the file
-* @param std::fstream& In: file parser
+* @param const MappedFile& In: mapping of the file
 * @return bool: true if the file is valid
 * @note Time Complexity: O(1), Space Complexity: O(1);
 */
-bool check_file(const std::string filename, std::fstream& In);
+bool check_file(const std::string filename, const MappedFile& In);
 
 /**
 * @brief Parses all files and builds the graph
@@ -36,12 +37,26 @@ bool check_file(const std::string filename, std::fstream& In);
 */
 Graph parse(const std::string cities_csv, const std::string pipes_csv, const std::string reservoirs_csv, const std::string stations_csv);
 
+/**
+* @brief Parses all files into an existing, empty graph
+* @param Graph& network: graph being built
+* @param const std::string cities_csv: filename with the cities' data
+* @param const std::string pipes_csv: filename with the pipes' data
+* @param const std::string reservoirs_csv: filename with the reservoirs' data
+* @param const std::string stations_csv: filename with the stations' data
+* @return void
+* @note The four files are memory-mapped and tokenized concurrently, using up to network.getThreads() threads;
+*       the vertexes and edges are then added in the same order as the functions below would add them
+* @note Time Complexity: O(V + E), Space Complexity: O(V + E);
+*/
+void parse(Graph &network, const std::string cities_csv, const std::string pipes_csv, const std::string reservoirs_csv, const std::string stations_csv);
+
 /**
 * @brief Parses the cities
 * @param Graph& network: graph being built
 * @param const std::string file: file with the cities' data
 * @return void
-* @note Time Complexity: O(C), Space Complexity: O(1);
+* @note Time Complexity: O(C), Space Complexity: O(C);
 */
 void parseCities(Graph &network, const std::string file);
 
@@ -50,7 +65,7 @@ void parseCities(Graph &network, const std::string file);
 * @param Graph& network: graph being built
 * @param const std::string file: file with the pipes' data
 * @return void
-* @note Time Complexity: O(P), Space Complexity: O(1);
+* @note Time Complexity: O(P), Space Complexity: O(P);
 */
 void parsePipes(Graph &network, const std::string file);
 
@@ -59,7 +74,7 @@ void parsePipes(Graph &network, const std::string file);
 * @param Graph& network: graph being built
 * @param const std::string file: file with the reservoirs' data
 * @return void
-* @note Time Complexity: O(R), Space Complexity: O(1);
+* @note Time Complexity: O(R), Space Complexity: O(R);
 */
 void parseReservoirs(Graph &network, const std::string file);
 
@@ -68,7 +83,7 @@ void parseReservoirs(Graph &network, const std::string file);
 * @param Graph& network: graph being built
 * @param const std::string file: file with the stations' data
 * @return void
-* @note Time Complexity: O(s), Space Complexity: O(1);
+* @note Time Complexity: O(s), Space Complexity: O(s);
 */
 void parseStations(Graph &network, const std::string file);
 
@@ -0,0 +1,104 @@
+/**
+ * @file PathIndex.hpp
+ * @brief Declaration of class PathIndex
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef PATH_INDEX_HPP
+#define PATH_INDEX_HPP
+
+#include <vector>
+#include "Macros.hpp"
+#include "ResidualGraph.hpp"
+
+//! Decomposition of a flow into source-to-sink paths, each going through one Reservoir and ending in one City
+//! The paths are kept as a compact table of arcs, with an inverted index from every arc to the paths through it,
+//! so the cities a failure takes water from, and how much at most, are read without calculating any flow
+class PathIndex {
+private:
+    std::vector<unsigned> pathFirst;                        /*!< The arcs of path p are pathArcs[pathFirst[p], pathFirst[p + 1]) */
+    std::vector<unsigned> pathArcs;                         /*!< Arcs of every path, from the source to the sink */
+    std::vector<Capacity> amount;                           /*!< Flow carried by each path */
+
+    std::vector<unsigned> arcFirst;                         /*!< The paths through arc a are arcPaths[arcFirst[a], arcFirst[a + 1]) */
+    std::vector<unsigned> arcPaths;                         /*!< Paths through every arc, in increasing order */
+
+    std::vector<Capacity> decomposed;                       /*!< Flow of every arc when the index was built */
+    unsigned cycles = 0;                                    /*!< Flow cycles cancelled while decomposing */
+
+public:
+    /**
+     * @brief Decomposes the flow of a state into paths and builds the inverted index
+     * @param const ResidualGraph& r: arrays the flow belongs to
+     * @param const FlowState& s: valid flow, cut arcs carrying none
+     * @return void
+     * @note Each path is followed from the source through arcs that still carry flow; closed cycles are cancelled, as they deliver no water
+     * @note Time Complexity: O(P * V + E), P being the number of paths (at most E), Space Complexity: O(P * V + E)
+     */
+    void build(const ResidualGraph &r, const ResidualGraph::FlowState &s);
+
+    /**
+     * @brief Checks whether the index was built from the same flow as a state
+     * @param const FlowState& s: flow over the same arrays
+     * @return bool: true if every arc carries the flow it carried when the index was built
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    bool matches(const ResidualGraph::FlowState &s) const;
+
+    /**
+     * @brief Returns the paths that go through at least one of the given arcs
+     * @param const std::vector<unsigned>& arcs: arcs that fail together
+     * @return std::vector<unsigned>: indexes of the paths, in increasing order and without repetitions
+     * @note Time Complexity: O(k * log k), k being the number of path entries of those arcs, Space Complexity: O(k)
+     */
+    std::vector<unsigned> pathsThrough(const std::vector<unsigned> &arcs) const;
+
+    /**
+     * @brief Returns the number of paths
+     * @return unsigned: number of paths
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned pathCount() const;
+
+    /**
+     * @brief Returns the flow carried by a path
+     * @param unsigned p: path
+     * @return Capacity: flow of the path
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Capacity getAmount(unsigned p) const;
+
+    /**
+     * @brief Returns the arcs of a path
+     * @param unsigned p: path
+     * @return std::vector<unsigned>: arcs, from the source to the sink
+     * @note Time Complexity: O(l), l being the length of the path, Space Complexity: O(l)
+     */
+    std::vector<unsigned> getArcs(unsigned p) const;
+
+    /**
+     * @brief Returns the last arc of a path, which goes from its City to the sink
+     * @param unsigned p: path
+     * @return unsigned: arc of the City
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getCityArc(unsigned p) const;
+
+    /**
+     * @brief Returns the first arc of a path, which goes from the source to its Reservoir
+     * @param unsigned p: path
+     * @return unsigned: arc of the Reservoir
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getReservoirArc(unsigned p) const;
+
+    /**
+     * @brief Returns the number of flow cycles cancelled by the last build()
+     * @return unsigned: number of cycles
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getCycles() const;
+};
+
+#endif // PATH_INDEX_HPP
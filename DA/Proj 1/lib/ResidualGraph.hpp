@@ -0,0 +1,382 @@
+/**
+ * @file ResidualGraph.hpp
+ * @brief Declaration of class ResidualGraph
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef RESIDUAL_GRAPH_HPP
+#define RESIDUAL_GRAPH_HPP
+
+#include <vector>
+#include "Macros.hpp"
+#include "Vertex.hpp"
+#include "Edge.hpp"
+#include "FlowState.hpp"
+#include "Stats.hpp"
+
+class Graph;
+
+enum max_flow_algorithm {
+    EDMONDS_KARP,   // BFS per augmenting path, starts from the current flow
+    FORD_FULKERSON, // DFS per augmenting path, starts from scratch
+    DINIC,          // Level graph and blocking flow, starts from the current flow
+    PUSH_RELABEL    // FIFO push-relabel with gap and global relabelling, starts from the current flow
+};
+
+//! Compressed-sparse-row residual network on which every maximum flow algorithm runs
+//! The arrays are never changed by the algorithms: the flow lives in a FlowState, so many threads can share them
+//! Cap is the type of the capacities and flows: double, or int64_t / int32_t for exact arithmetic on whole capacities
+//! (int32_t halves the flow arrays, but every flow must then fit in 32 bits); the three are instantiated in ResidualGraph.cpp
+template<typename Cap>
+class BasicResidualGraph {
+public:
+    typedef BasicFlowState<Cap> FlowState;                  /*!< Flow of these arrays */
+
+private:
+    std::vector<unsigned> first;                            /*!< The arcs leaving vertex v are [first[v], first[v + 1]) */
+    std::vector<unsigned> head;                             /*!< Destination of each arc */
+    std::vector<unsigned> reverse;                          /*!< Offset of the arc paired with each arc */
+    std::vector<Cap> capacity;                              /*!< Capacity of each arc (0 for reverse arcs) */
+    std::vector<Edge *> edges;                              /*!< Pipe of each forward arc, nullptr for reverse arcs */
+
+    std::vector<unsigned> arcs;                             /*!< Forward arc of each Edge of the original graph, by Edge::getIndex() */
+
+    /**
+     * @brief Returns the residual capacity of an arc
+     * @param const FlowState& s: flow
+     * @param unsigned a: arc
+     * @return Cap: capacity minus flow, taking the capacity of cut arcs as 0
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Cap residual(const FlowState &s, unsigned a) const;
+
+    /**
+     * @brief Starts a new search, invalidating every visited mark in O(1)
+     * @param FlowState& s: flow and scratch arrays
+     * @return void
+     * @note Time Complexity: O(1) amortized, Space Complexity: O(1)
+     */
+    void newSearch(FlowState &s) const;
+
+    /**
+     * @brief Sends flow through an arc, keeping its pair consistent and writing it to the journal if it is on
+     * @param FlowState& s: flow
+     * @param unsigned a: arc
+     * @param Cap delta: flow to add (negative values cancel flow)
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void push(FlowState &s, unsigned a, Cap delta) const;
+
+    /**
+     * @brief Pushes the bottleneck of the path stored in the parent array, from src to dst
+     * @param FlowState& s: flow and scratch arrays
+     * @param unsigned src: start of the path
+     * @param unsigned dst: end of the path
+     * @param Cap limit: maximum flow to push
+     * @param SolverCounters& counters: counters of the algorithm, which count the path
+     * @return Cap: flow pushed
+     * @note Time Complexity: O(V), Space Complexity: O(1)
+     */
+    Cap augmentPath(FlowState &s, unsigned src, unsigned dst, Cap limit, SolverCounters &counters) const;
+
+    /**
+     * @brief Sets every height to the distance to the sink in the residual graph, or n + the distance to the source
+     * @param FlowState& s: flow and scratch arrays
+     * @param std::vector<unsigned>& height: height of each vertex, 2n if it reaches neither
+     * @param std::vector<unsigned>& count: number of vertexes with each height
+     * @param SolverCounters& counters: counters of the algorithm, which count the searches
+     * @return void
+     * @note Auxiliary function of pushRelabel()
+     * @note Time Complexity: O(V + E), Space Complexity: O(1)
+     */
+    void globalRelabel(FlowState &s, std::vector<unsigned> &height, std::vector<unsigned> &count, SolverCounters &counters) const;
+
+public:
+    static const unsigned SOURCE_INDEX = 0;                 /*!< Index of the super source */
+    static const unsigned SINK_INDEX = 1;                   /*!< Index of the super sink */
+
+    /**
+     * @brief Builds the arrays from the vertexes and edges of a graph
+     * @param const Graph& g: water network
+     * @note Vertexes keep their dense index (Vertex::getIndex()), removed ones having no arcs
+     * @note The arcs of each vertex keep the order of its outgoing edges followed by its incoming edges
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    void build(const Graph &g);
+
+    /**
+     * @brief Builds the arrays of a part of another residual graph: the super source, the super sink, some vertexes and their arcs
+     * @param const BasicResidualGraph& whole: residual graph the part is taken from
+     * @param const std::vector<unsigned>& vertexes: vertexes of the part, which must have no arc to a vertex outside it but the source and the sink
+     * @param std::vector<unsigned>& local: index of each vertex of the whole in its part, sized whole.vertexCount(), only written for these vertexes
+     * @param std::vector<unsigned>& arcMap: filled with the arc of the whole of each arc of the part
+     * @note The source and the sink keep indexes 0 and 1, vertexes[i] gets index i + 2, and every vertex keeps the order of its arcs
+     * @note Time Complexity: O(V' + E'), V' and E' being the vertexes and arcs of the part, Space Complexity: O(V' + E')
+     */
+    void build(const BasicResidualGraph &whole, const std::vector<unsigned> &vertexes, std::vector<unsigned> &local,
+               std::vector<unsigned> &arcMap);
+
+    /**
+     * @brief Builds the arrays of another residual graph with more vertexes and arcs, to try changes without rebuilding it for each one
+     * @param const BasicResidualGraph& base: residual graph that is extended
+     * @param unsigned vertexes: number of vertexes added, which get the indexes from base.vertexCount() on
+     * @param const std::vector<std::pair<unsigned, unsigned>>& added: tail and head of each arc added
+     * @param const std::vector<Cap>& capacities: capacity of each arc added
+     * @param std::vector<unsigned>& arcMap: filled with the forward arc of these arrays of each arc added
+     * @note Every vertex keeps its arcs of the base first, in the same order, followed by the ones added; the arcs added have no Edge
+     * @note Time Complexity: O(V + E + n), n being the number of arcs added, Space Complexity: O(V + E + n)
+     */
+    void build(const BasicResidualGraph &base, unsigned vertexes, const std::vector<std::pair<unsigned, unsigned>> &added,
+               const std::vector<Cap> &capacities, std::vector<unsigned> &arcMap);
+
+    /**
+     * @brief Copies the flow and the cut flags of a state of the base into a state of these extended arrays, with every arc added cut
+     * @param FlowState& extended: state created by newState() of these arrays
+     * @param const BasicResidualGraph& base: residual graph these arrays extend
+     * @param const FlowState& s: state of the base
+     * @return void
+     * @note restoreArc() brings an arc added into the network
+     * @note Time Complexity: O(V + E), Space Complexity: O(1)
+     */
+    void loadBase(FlowState &extended, const BasicResidualGraph &base, const FlowState &s) const;
+
+    /**
+     * @brief Returns the arc of these extended arrays of an arc of the base
+     * @param const BasicResidualGraph& base: residual graph these arrays extend
+     * @param unsigned a: arc of the base
+     * @return unsigned: the same arc in these arrays
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned arcOfBase(const BasicResidualGraph &base, unsigned a) const;
+
+    /**
+     * @brief Copies the flow and the cut flags of the arcs of this part from a state of the whole
+     * @param FlowState& part: state created by newState() of this part
+     * @param const FlowState& whole: state of the whole
+     * @param const std::vector<unsigned>& arcMap: arc of the whole of each arc of this part, from build()
+     * @return void
+     * @note Time Complexity: O(E'), Space Complexity: O(1)
+     */
+    void loadPart(FlowState &part, const FlowState &whole, const std::vector<unsigned> &arcMap) const;
+
+    /**
+     * @brief Writes the flow of a part back to a state of these arrays, which must be the whole the part was taken from
+     * @param FlowState& whole: state of these arrays
+     * @param const FlowState& part: flow of the part
+     * @param const std::vector<unsigned>& arcMap: arc of these arrays of each arc of the part
+     * @return void
+     * @note The changes go through push(), so they are journaled
+     * @note Time Complexity: O(E'), Space Complexity: O(1)
+     */
+    void storePart(FlowState &whole, const FlowState &part, const std::vector<unsigned> &arcMap) const;
+
+    /**
+     * @brief Creates a state without flow, cuts nor searches, sized for these arrays
+     * @return FlowState: empty state
+     * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+     */
+    FlowState newState() const;
+
+    /**
+     * @brief Copies the flow of every Edge into a state
+     * @param FlowState& s: state created by newState()
+     * @return void
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    void load(FlowState &s) const;
+
+    /**
+     * @brief Writes the flow of a state back to every Edge
+     * @param const FlowState& s: flow
+     * @return void
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    void store(const FlowState &s) const;
+
+    /**
+     * @brief Returns the index of a Vertex of the graph used to build the arrays
+     * @param const Vertex* v: vertex
+     * @return unsigned: index of the vertex, the same as Vertex::getIndex()
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned indexOf(const Vertex *v) const;
+
+    /**
+     * @brief Returns the forward arc of an Edge of the graph used to build the arrays
+     * @param const Edge* e: edge
+     * @return unsigned: index of the arc
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned arcOf(const Edge *e) const;
+
+    /**
+     * @brief Returns the Edge of an arc
+     * @param unsigned a: arc
+     * @return Edge*: nullptr if it is a reverse arc
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Edge *getEdge(unsigned a) const;
+
+    /**
+     * @brief Returns the vertex an arc leaves
+     * @param unsigned a: arc
+     * @return unsigned: index of the origin
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getTail(unsigned a) const;
+
+    /**
+     * @brief Returns the vertex an arc enters
+     * @param unsigned a: arc
+     * @return unsigned: index of the destination
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned getHead(unsigned a) const;
+
+    /**
+     * @brief Returns the capacity of an arc
+     * @param unsigned a: arc
+     * @return Cap: capacity
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Cap getCapacity(unsigned a) const;
+
+    /**
+     * @brief Cuts an arc and removes its flow from the network, like Graph::removeEdge() does to an Edge
+     * @param FlowState& s: flow
+     * @param unsigned a: forward arc
+     * @return unsigned: number of BFSs
+     * @note Flow going around a cycle through the arc is cancelled along that cycle, the rest is reduced from the source to the origin and from the destination to the sink
+     * @note Time Complexity: O(V * E²), Space Complexity: O(V)
+     */
+    unsigned cutArc(FlowState &s, unsigned a) const;
+
+    /**
+     * @brief Undoes cutArc(), without giving back any flow
+     * @param FlowState& s: flow
+     * @param unsigned a: forward arc
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void restoreArc(FlowState &s, unsigned a) const;
+
+    /**
+     * @brief Undoes the pushes written to the journal after a mark, newest first
+     * @param FlowState& s: flow, with the journal turned on
+     * @param size_t mark: size of the journal to go back to, from FlowState::journalSize()
+     * @return void
+     * @note Cut flags are not journaled, the caller restores them with restoreArc()
+     * @note Time Complexity: O(n), n being the number of pushes undone, Space Complexity: O(1)
+     */
+    void rollback(FlowState &s, size_t mark) const;
+
+    /**
+     * @brief Calculates the maximum flow with the given algorithm
+     * @param FlowState& s: flow, used as the starting point
+     * @param max_flow_algorithm algorithm: algorithm
+     * @return unsigned: number of BFSs/DFSs of the algorithm
+     * @note Time Complexity: depends on the algorithm, Space Complexity: O(V)
+     */
+    unsigned maxFlow(FlowState &s, max_flow_algorithm algorithm) const;
+
+    /**
+     * @brief Returns the number of vertexes
+     * @return unsigned: number of vertexes, source and sink included
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned vertexCount() const;
+
+    /**
+     * @brief Returns the number of arcs
+     * @return unsigned: number of arcs, twice the number of edges
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned arcCount() const;
+
+    /**
+     * @brief Edmonds-Karp starting from the current flow
+     * @param FlowState& s: flow
+     * @return unsigned: number of BFSs
+     * @note Time Complexity: O(V * E²), Space Complexity: O(V)
+     */
+    unsigned edmondsKarp(FlowState &s) const;
+
+    /**
+     * @brief Ford-Fulkerson from scratch, using an iterative DFS to find the augmenting paths
+     * @param FlowState& s: flow
+     * @param (Optional) unsigned* iterations = nullptr: number of DFSs
+     * @return Cap: maximum flow
+     * @note Time Complexity: O(E * f), Space Complexity: O(V)
+     */
+    Cap fordFulkerson(FlowState &s, unsigned *iterations = nullptr) const;
+
+    /**
+     * @brief Dinic starting from the current flow: a BFS builds the level graph, then a blocking flow is pushed through it
+     * @param FlowState& s: flow
+     * @return unsigned: number of BFSs (phases)
+     * @note Each vertex keeps a current arc, so arcs that lead to dead ends are never scanned twice in the same phase
+     * @note Time Complexity: O(V² * E), Space Complexity: O(V)
+     */
+    unsigned dinic(FlowState &s) const;
+
+    /**
+     * @brief FIFO push-relabel starting from the current flow, with the gap and global relabelling heuristics
+     * @param FlowState& s: flow
+     * @return unsigned: number of global relabellings (BFSs from the sink)
+     * @note Excess that cannot reach the sink is pushed back to the source, so the result is a valid flow
+     * @note Time Complexity: O(V³), Space Complexity: O(V)
+     */
+    unsigned pushRelabel(FlowState &s) const;
+
+    /**
+     * @brief Reduces the flow from a vertex to another by an amount smaller or equal to the value provided
+     * @param FlowState& s: flow
+     * @param unsigned src: index of the origin
+     * @param unsigned dst: index of the destination
+     * @param Cap limit: the maximum flow that can be reduced
+     * @param (Optional) Cap* reduced = nullptr: flow actually reduced
+     * @return unsigned: number of BFSs
+     * @note Only arcs already carrying flow are followed
+     * @note Time Complexity: O(V * E²), Space Complexity: O(V)
+     */
+    unsigned reduceFlow(FlowState &s, unsigned src, unsigned dst, Cap limit, Cap *reduced = nullptr) const;
+
+    /**
+     * @brief Finds the minimum cut of a maximum flow with one BFS from the source in the residual graph
+     * @param FlowState& s: maximum flow, whose scratch arrays are used by the search
+     * @param std::vector<bool>& sourceSide: filled with whether the source still reaches each vertex
+     * @return std::vector<unsigned>: forward arcs from the source side to the other, all saturated, in increasing order
+     * @note Arcs taken away by cutArc() are left out, as they carry nothing
+     * @note Time Complexity: O(V + E), Space Complexity: O(V)
+     */
+    std::vector<unsigned> minCut(FlowState &s, std::vector<bool> &sourceSide) const;
+
+    /**
+     * @brief Returns the utilization cost of a flow: flow² / capacity added over the pipes
+     * @param const FlowState& s: flow
+     * @return double: cost, which is lower when the load is spread over the pipes in proportion to their capacity
+     * @note The arcs from the source and to the sink are not pipes and cost nothing
+     * @note Time Complexity: O(E), Space Complexity: O(1)
+     */
+    double utilizationCost(const FlowState &s) const;
+
+    /**
+     * @brief Moves a flow to the minimum utilization cost, keeping the water reaching each City
+     * @param FlowState& s: valid flow, e.g. a maximum one
+     * @return unsigned: number of pushes, each moving whole units through one arc
+     * @note The cost is convex, so a unit through an arc costs the change of flow² / capacity of its pipe; the arcs to the sink are never used
+     * @note Cost scaling: each refinement saturates the arcs with a negative reduced cost and sends the excesses left to the deficits by
+     * push-relabel, so the flow gets epsilon-optimal, epsilon going from the largest marginal cost down to 1e-9 in steps of 4
+     * @note Every n / 4 relabels, a global update sets the potentials from the distances to the deficits, counted in steps of epsilon
+     * with Dial's buckets, so they do not have to fall epsilon at a time
+     * @note Whole flows stay whole, and every change goes through push(), so it is journaled
+     * @note Time Complexity: O(V² * E * log(C / ε)), C being the largest marginal cost, Space Complexity: O(V + E)
+     */
+    unsigned balance(FlowState &s) const;
+};
+
+typedef BasicResidualGraph<Capacity> ResidualGraph;         /*!< Residual network with the capacity type the program was compiled with */
+
+#endif // RESIDUAL_GRAPH_HPP
@@ -8,24 +8,136 @@
 #ifndef RUNTIME_HPP
 #define RUNTIME_HPP
 
+#include <atomic>
+#include <thread>
 #include "Graph.hpp"
 #include "Macros.hpp"
 
+//! Statistics of the flow/capacity ratio of the pipes, the edges to the Super Sink left out
+struct PipeStatistics {
+    size_t pipes = 0;                               /*!< Number of pipes */
+    double mean = 0;                                /*!< Mean ratio */
+    double variance = 0;                            /*!< Variance of the ratios */
+    double standard_deviation = 0;                  /*!< Standard deviation of the ratios */
+    double median = 0;                              /*!< Median ratio */
+    double q1 = 0;                                  /*!< First quartile */
+    double q3 = 0;                                  /*!< Third quartile */
+    double aqi = 0;                                 /*!< Interquartile range */
+    double maximum_amplitude = 0;                   /*!< Difference between the largest and the smallest ratio */
+    size_t empty = 0;                               /*!< Pipes without water */
+    size_t full = 0;                                /*!< Pipes at their capacity */
+};
+
 //! Runtime
 class Runtime {
 private:
     Graph network;
+    std::thread warmer;                             /*!< Calculates dependency vectors while the CLI waits for a command */
+    std::atomic<bool> stopWarmer{false};            /*!< Tells the warmer to stop after its current city */
+
+    friend void test_respond(Graph g);              /*!< Compares respond() with query() */
+
+    /**
+     * @brief Starts calculating, in the background, the dependency vectors that are not cached, the most populous cities first
+     * @return void
+     * @note The network must not be used until stopWarming() returns
+     * @note Time Complexity: O(C * E) to start, Space Complexity: O(C)
+     */
+    void startWarming();
+
+    /**
+     * @brief Stops the background calculation of dependency vectors, waiting for the city it is on
+     * @return void
+     * @note The vectors already calculated stay cached
+     * @note Time Complexity: the one of Graph::getDependency() for one city, Space Complexity: O(1)
+     */
+    void stopWarming();
 
     /**
      * @brief Prints the Cities and Reservoirs that were affected by the removal of a vertex or edge
-     * @param Graph& graph: Original graph before the removal
+     * @param const FlowState& before: flow of the network before the removal, taken with Graph::getState()
      * @param const std::vector<Vertex*>& affectedCities: vector of affected Cities
      * @param const std::vector<Vertex*>& affectedReservoirs: vector of affected Reservoirs
      * @return void
      * @note Auxiliary function for remove command
      * @note Time Complexity: O(v), Space Complexity: O(1)
      */
-    void printAffected(Graph &graph, const std::vector<Vertex *>& affectedCities, const std::vector<Vertex *>& affectedReservoirs);
+    void printAffected(const FlowState &before, const std::vector<Vertex *>& affectedCities, const std::vector<Vertex *>& affectedReservoirs);
+
+    /**
+     * @brief Reads an upgrade written like the upgrade_pipe, add_pipe and add_reservoir commands
+     * @param const std::vector<std::string>& args: command and its arguments
+     * @param Upgrade& upgrade: where the upgrade is written
+     * @return bool: false, after printing the error, if the command or its arguments are not valid
+     * @note Auxiliary function for the upgrade commands and evaluate_upgrades
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    bool parseUpgrade(const std::vector<std::string> &args, Upgrade &upgrade);
+
+    /**
+     * @brief Prints the water gained by each City, ordered by ID, and by the whole network
+     * @param const std::unordered_map<Vertex*, Capacity>& gain: water gained by each City that gets more
+     * @param Capacity total: water gained by the whole network
+     * @return void
+     * @note Auxiliary function for the upgrade commands
+     * @note Time Complexity: O(C * log C), Space Complexity: O(C)
+     */
+    void printGains(const std::unordered_map<Vertex *, Capacity> &gain, Capacity total);
+
+    /**
+     * @brief Applies an upgrade to the network, calculates the maximum flow from the current one and prints the gains
+     * @param const std::vector<std::string>& args: command and its arguments
+     * @return void
+     * @note Auxiliary function for the upgrade_pipe, add_pipe and add_reservoir commands
+     * @note Time Complexity: O(V + E) plus a maximum flow on the component of the upgrade, Space Complexity: O(V + E)
+     */
+    void upgrade(const std::vector<std::string> &args);
+
+    /**
+     * @brief Reads a remove or remove_pipe command of a batch
+     * @param const std::vector<std::string>& args: command and its arguments
+     * @param const std::vector<FailurePoint>& removed: removals of the batch not restored yet, which are no longer in the network
+     * @param FailurePoint& point: where the location or pipe is written
+     * @param std::string& error: where the error is written
+     * @return bool: false if the command or its arguments are not valid
+     * @note Auxiliary function for runBatch() and respond()
+     * @note Time Complexity: O(r + d), r being the number of removals and d the degree of the origin, Space Complexity: O(1)
+     */
+    bool parseRemoval(const std::vector<std::string> &args, const std::vector<FailurePoint> &removed, FailurePoint &point, std::string &error) const;
+
+    /**
+     * @brief Writes the flow after a removal, and the Cities and Reservoirs it changes, as JSON fields
+     * @param std::ostream& fields: where the fields are written, each preceded by a comma
+     * @param const RemovalReport& report: removal evaluated by Graph::evaluateRemovals()
+     * @param bool changes: whether to write the Cities and Reservoirs, or only the flow
+     * @return void
+     * @note Auxiliary function for runBatch() and respond()
+     * @note Time Complexity: O(C + R), Space Complexity: O(1)
+     */
+    void writeRemoval(std::ostream &fields, const RemovalReport &report, bool changes) const;
+
+    /**
+     * @brief Runs a command that only reads the network, and writes what it prints interactively as JSON fields
+     * @param const std::vector<std::string>& args: command and its arguments
+     * @param std::ostream& fields: where the fields are written, each preceded by a comma
+     * @param std::string& error: where the error is written
+     * @return bool: false if the command is not valid or is not one of these
+     * @note Once prepareQueries() has run, nothing is written to the network, so it can be called from several threads at the same time
+     * @note Auxiliary function for batchQuery() and respond()
+     * @note Time Complexity: the one of the command, Space Complexity: the one of the command
+     */
+    bool query(const std::vector<std::string> &args, std::ostream &fields, std::string &error) const;
+
+    /**
+     * @brief Runs a command of a batch that is not a removal or a restore, and writes what it prints interactively as JSON fields
+     * @param const std::vector<std::string>& args: command and its arguments
+     * @param std::ostream& fields: where the fields are written, each preceded by a comma
+     * @param std::string& error: where the error is written
+     * @return bool: false if the command is not valid or not available in batch mode
+     * @note Auxiliary function for runBatch(), which adds algorithm and bottlenecks to the commands of query()
+     * @note Time Complexity: the one of the command, Space Complexity: the one of the command
+     */
+    bool batchQuery(const std::vector<std::string> &args, std::ostream &fields, std::string &error);
 
 protected:
     /**
@@ -103,24 +215,118 @@ protected:
      */
     void restore(std::vector<std::string> args);
 
+    /**
+     * @brief Saves the current removals and flow, to go back to them with rollback
+     * @param std::vector<std::string> args: arguments (only empty is accepted)
+     * @return void
+     * @note Time Complexity: O(E) for the first checkpoint, O(1) for the others, Space Complexity: O(1)
+     */
+    void checkpoint(std::vector<std::string> args);
+
+    /**
+     * @brief Goes back to the n-th newest checkpoint, undoing only the changes made after it
+     * @param std::vector<std::string> args: arguments (optionally, the number of checkpoints n, 1 by default)
+     * @return void
+     * @note No maximum flow algorithm is executed, the journaled flow changes are undone instead
+     * @note Time Complexity: O(n + E), n being the number of changes undone, Space Complexity: O(1)
+     */
+    void rollback(std::vector<std::string> args);
+
     /**
      * @brief For a given city, shows which pipes, if ruptured, would affect the amount of water reaching the city
      * @param std::vector<std::string> args: arguments
      * @return void
      * @note Time Complexity: O(n), where n is the number of Pipes that the given city depends on, Space Complexity: O(1)
-     * @note Although the complexity of this command is linear, it depends on the method Graph::calculateDependency(), which has complexity of O(V * E³) and is executed in the beginning of the program
+     * @note The vector of the city is calculated by Graph::getDependency() the first time it is asked for after the flow changes, and cached until it changes again
      */
     void showDependency(std::vector<std::string> args);
 
+    /**
+     * @brief Calculates statistics about the pipes
+     * @param const Graph& g: graph
+     * @return PipeStatistics: statistics of the flow/capacity ratio of the pipes
+     * @note This function is static
+     * @note Time Complexity: O(E * log E + V), Space Complexity: O(E)
+     */
+    static PipeStatistics pipes_statistics(const Graph &g);
+
     /**
      * @brief Prints statistics about the pipes
      * @param const Graph& g: graph
      * @return void
      * @note This function is static
-     * @note Time Complexity: O(E * log E + V), Space Complexity: O(1)
+     * @note Time Complexity: O(E * log E + V), Space Complexity: O(E)
      */
     static void print_pipes_statistics(const Graph &g);
 
+    /**
+     * @brief Shows the maximum flow algorithm used by the other commands, or selects another one
+     * @param std::vector<std::string> args: arguments (optionally, the name of the algorithm)
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void algorithm(std::vector<std::string> args);
+
+    /**
+     * @brief For every combination of k pipes or pumping stations failing at once, ranks the most damaging ones for each city
+     * @param std::vector<std::string> args: arguments (k, from 1 to 3, and optionally the length n of each ranking)
+     * @return void
+     * @note Time Complexity: the one of Graph::kFailures(), Space Complexity: O(C * n * k)
+     */
+    void kFailures(std::vector<std::string> args);
+
+    /**
+     * @brief Monte Carlo simulation of random pipe failures, printing the expected and percentile water missing in each city
+     * @param std::vector<std::string> args: arguments (samples, failure probability, and optionally the percentile and the seed)
+     * @return void
+     * @note Time Complexity: the one of Graph::simulateFailures(), Space Complexity: O(C)
+     */
+    void simulate(std::vector<std::string> args);
+
+    /**
+     * @brief Estimates, from the paths of the current flow, the water a City, Reservoir, Pumping Station or Pipe would take from the cities if removed
+     * @param std::vector<std::string> args: arguments (a code, or the codes of the origin and destination of a pipe)
+     * @return void
+     * @note Nothing is removed and no flow is calculated: the total is an upper bound, remove and remove_pipe give the exact numbers
+     * @note Time Complexity: the one of Graph::estimateFailure(), Space Complexity: O(C)
+     */
+    void estimate(std::vector<std::string> args);
+
+    /**
+     * @brief Prints the saturated pipes of the minimum cut of the current flow, grouped by the cities missing water behind them
+     * @param std::vector<std::string> args: arguments (only empty is accepted)
+     * @return void
+     * @note No flow is calculated, the cut is read from the residual graph of the current maximum flow
+     * @note Time Complexity: the one of Graph::bottlenecks(), Space Complexity: O(V + E)
+     */
+    void bottlenecks(std::vector<std::string> args);
+
+    /**
+     * @brief Spreads the current flow over the pipes as evenly as possible, keeping the water reaching each city, and prints the statistics before and after
+     * @param std::vector<std::string> args: arguments (only empty is accepted)
+     * @return void
+     * @note Time Complexity: the one of Graph::balanceFlow(), Space Complexity: O(E)
+     */
+    void balance(std::vector<std::string> args);
+
+    /**
+     * @brief Evaluates every upgrade listed in a file, one per line, each on its own over the current network, and ranks them by the water gained
+     * @param std::vector<std::string> args: arguments (the file)
+     * @return void
+     * @note The network is not changed
+     * @note Time Complexity: the one of Graph::evaluateUpgrades(), plus O(n * log n), Space Complexity: O(n * C)
+     */
+    void evaluateUpgrades(std::vector<std::string> args);
+
+    /**
+     * @brief Prints the counters of the solvers and the time of each phase, resets them, or writes them to a JSON file
+     * @param std::vector<std::string> args: arguments (nothing, reset, or json and the file)
+     * @return void
+     * @note Commands that are not valid are not timed; with -DNO_STATS nothing is counted
+     * @note Time Complexity: O(p), p being the number of phases and commands timed, Space Complexity: O(p)
+     */
+    void stats(std::vector<std::string> args);
+
 public:
     /**
      * @brief Runs the program
@@ -129,12 +335,58 @@ public:
      */
     void run();
 
+    /**
+     * @brief Runs the commands of a stream one after the other, without prompts, and writes one JSON object per line for each one
+     * @param std::istream& in: commands, one per line; empty lines and lines starting with # are skipped
+     * @param std::ostream& out: JSON Lines, each with the line of the command, its name, "ok" and either its results or an "error"
+     * @return void
+     * @note Consecutive remove, remove_pipe and restore commands are evaluated as independent jobs by Graph::evaluateRemovals(), each
+     *       with the removals made since the last restore; any other command waits for them, and the removals not restored are then applied
+     * @note Time Complexity: the one of the commands, Space Complexity: O(n * (C + R)) for n consecutive removals
+     */
+    void runBatch(std::istream &in, std::ostream &out);
+
+    /**
+     * @brief Brings the arrays, the flow paths and the dependencies of the network up to date, so that respond() only reads it
+     * @return void
+     * @note Time Complexity: O(P * V + E), plus the one of Graph::calculateDependency() if a City is not in the cache, Space Complexity: O(P * V + E)
+     */
+    void prepareQueries();
+
+    /**
+     * @brief Answers one request of the server with a JSON line, without changing the network
+     * @param unsigned line: number of the request, copied to the answer
+     * @param const std::vector<std::string>& command: command and its arguments, not empty
+     * @return std::string: JSON object, like the ones of runBatch(), ended by a new line
+     * @note remove and remove_pipe are evaluated on a private copy of the flow; the other commands are the ones of query()
+     * @note Safe to call from several threads at the same time once prepareQueries() has run
+     * @note Time Complexity: the one of the command, Space Complexity: the one of the command
+     */
+    std::string respond(unsigned line, const std::vector<std::string> &command) const;
+
     /**
      * @brief Constructor with the network
      * @param Graph* graph: water network
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
     Runtime(Graph *graph);
+
+    Runtime(const Runtime &) = delete;
+    Runtime &operator=(const Runtime &) = delete;
+
+    /**
+     * @brief Returns the network of the runtime, with the removals, upgrades and dependency vectors of its commands
+     * @return const Graph&: network
+     * @note The background calculation of dependency vectors must be stopped, as it is once run() returns
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    const Graph &getNetwork() const;
+
+    /**
+     * @brief Destructor, stops the background calculation of dependency vectors
+     * @note Time Complexity: the one of stopWarming(), Space Complexity: O(1)
+     */
+    ~Runtime();
 };
 
 #endif // RUNTIME_HPP
@@ -0,0 +1,77 @@
+/**
+ * @file Server.hpp
+ * @brief Declaration of class Server
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <string>
+#include "Runtime.hpp"
+
+//! Unix domain socket server that answers queries about a network loaded once, for many clients at the same time
+//! Each client writes one command per line and reads one JSON line per command, as built by Runtime::respond();
+//! every worker thread polls the listening socket and all the clients it accepted, so an idle client takes no worker,
+//! and the network is never written while serving
+class Server {
+private:
+    //! Client being served by a worker
+    struct Connection {
+        int socket;                                         /*!< Non-blocking socket of the client */
+        std::string pending;                                /*!< Start of a line not ended yet */
+        std::string output;                                 /*!< Answers not sent yet */
+        unsigned number = 0;                                /*!< Lines read so far */
+        bool closing = false;                               /*!< The client closed its side or said exit, it goes once its answers are sent */
+    };
+
+    const Runtime &runtime;                                 /*!< Network, already prepared with Runtime::prepareQueries() */
+    std::string path;                                       /*!< Path of the socket */
+    unsigned threads;                                       /*!< Number of worker threads (0 uses one per core) */
+    int listener = -1;                                      /*!< Listening socket, non-blocking so that the workers can share it */
+
+    /**
+     * @brief Accepts clients and serves all of them at once, polling their sockets, until the server stops
+     * @return void
+     * @note A client is not read while answers to it are waiting to be sent, so one that does not read cannot take the memory
+     * @note Time Complexity: the one of the requests served, plus O(c) per wake-up, c being the clients of the worker, Space Complexity: O(c)
+     */
+    void work() const;
+
+    /**
+     * @brief Reads what a client sent and answers every line it ended
+     * @param Connection& c: client whose socket is readable
+     * @return bool: false if the client must be dropped (an error, or a line longer than MAX_LINE)
+     * @note The answers to all the lines read at once are queued together
+     * @note Time Complexity: the one of the requests, Space Complexity: O(l), l being the length of the lines read at once
+     */
+    bool receive(Connection &c) const;
+
+    /**
+     * @brief Sends as much of the queued answers of a client as its socket takes without blocking
+     * @param Connection& c: client
+     * @return bool: false if the client is gone
+     * @note Time Complexity: O(n), n being the bytes sent, Space Complexity: O(1)
+     */
+    bool flush(Connection &c) const;
+
+public:
+    /**
+     * @brief Constructor
+     * @param const Runtime& runtime: network to query, already prepared with Runtime::prepareQueries()
+     * @param const std::string& path: path of the socket, replaced if it already is a socket
+     * @param unsigned threads: number of worker threads (0 uses one per core)
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    Server(const Runtime &runtime, const std::string &path, unsigned threads);
+
+    /**
+     * @brief Listens on the socket and serves clients until SIGINT or SIGTERM, then removes the socket
+     * @return bool: false if the socket could not be created
+     * @note Time Complexity: the one of the requests served, Space Complexity: O(threads)
+     */
+    bool run();
+};
+
+#endif // SERVER_HPP
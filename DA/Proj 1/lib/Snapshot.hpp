@@ -0,0 +1,115 @@
+/**
+ * @file Snapshot.hpp
+ * @brief Declaration of the binary snapshot of a parsed network, its flow and its dependencies
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include "Graph.hpp"
+
+/*
+ * Layout of a snapshot file (native byte order, every section aligned to 8 bytes, so it can be used straight from mmap):
+ *   SnapshotHeader
+ *   SnapshotVertex[vertexes]         source, sink, then the vertex set in order
+ *   SnapshotEdge[edges]              grouped by origin, in the order of its outgoing edges
+ *   uint32_t[edges]                  incoming edges of each vertex, in order (see SnapshotVertex::firstIncoming)
+ *   SnapshotDependency[dependencies] dependency vectors of the cities whose vector was calculated, in order
+ *   char[stringBytes]                names and municipalities, not null-terminated
+ */
+
+const char SNAPSHOT_MAGIC[8] = {'W', 'N', 'E', 'T', 'S', 'N', 'A', 'P'};
+const uint32_t SNAPSHOT_VERSION = 3;            /*!< Increase whenever the layout changes, older files are then ignored */
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+const uint32_t SNAPSHOT_CAPACITY = std::is_integral<Capacity>::value ? sizeof(Capacity) : 0; /*!< 0 for double, the size of the integer otherwise */
+
+//! Start of a snapshot file
+struct SnapshotHeader {
+    char magic[8];                              /*!< SNAPSHOT_MAGIC */
+    uint32_t version;                           /*!< SNAPSHOT_VERSION */
+    uint32_t byteOrder;                         /*!< SNAPSHOT_BYTE_ORDER as written by the machine that made the file */
+    uint64_t hashes[4];                         /*!< hashFile() of the cities, pipes, reservoirs and stations files */
+    uint32_t algorithm;                         /*!< max_flow_algorithm that calculated the flow */
+    uint32_t vertexes;                          /*!< Number of SnapshotVertex */
+    uint32_t edges;                             /*!< Number of SnapshotEdge and of incoming entries */
+    uint32_t dependencies;                      /*!< Number of SnapshotDependency */
+    uint32_t capacity;                          /*!< SNAPSHOT_CAPACITY of the program that made the file, the values are rounded to it */
+    uint32_t padding;
+    uint64_t stringBytes;                       /*!< Size of the string section */
+    uint64_t vertexOffset;                      /*!< Offsets of each section from the start of the file */
+    uint64_t edgeOffset;
+    uint64_t incomingOffset;
+    uint64_t dependencyOffset;
+    uint64_t stringOffset;
+    uint64_t fileSize;                          /*!< Size of the whole file */
+};
+
+//! Vertex of a snapshot
+struct SnapshotVertex {
+    uint32_t id;                                /*!< Vertex::getId() */
+    uint32_t type;                              /*!< node_type */
+    uint32_t population;                        /*!< Population of a city */
+    uint32_t firstIncoming;                     /*!< The incoming edges are incoming[firstIncoming, firstIncoming + incomingCount) */
+    uint32_t incomingCount;
+    uint32_t firstDependency;                   /*!< The dependency vector is dependencies[firstDependency, firstDependency + dependencyCount) */
+    uint32_t dependencyCount;
+    uint32_t nameLength;                        /*!< City or reservoir name */
+    uint64_t name;                              /*!< Offset of the name in the string section */
+    uint64_t municipality;                      /*!< Offset of the municipality of a reservoir in the string section */
+    uint32_t municipalityLength;
+    uint32_t dependencyKnown;                   /*!< 1 if the dependency vector of a city was calculated for the saved flow */
+};
+
+//! Edge of a snapshot
+struct SnapshotEdge {
+    uint32_t orig;                              /*!< Index of the origin among the SnapshotVertex */
+    uint32_t dest;                              /*!< Index of the destination among the SnapshotVertex */
+    double capacity;
+    double flow;
+};
+
+//! Entry of the dependency vector of a city
+struct SnapshotDependency {
+    uint32_t edge;                              /*!< Index of the pipe among the SnapshotEdge */
+    uint32_t padding;
+    double deficit;                             /*!< Water missing in the city without that pipe */
+};
+
+/**
+ * @brief Hashes the contents of a file with 64-bit FNV-1a
+ * @param const std::string& file: name of the file
+ * @return uint64_t: hash, or 0 if the file cannot be read
+ * @note Time Complexity: O(n), n being the size of the file, Space Complexity: O(1)
+ */
+uint64_t hashFile(const std::string &file);
+
+/**
+ * @brief Writes the vertexes, edges, flow and the calculated dependency vectors of a network to a snapshot file
+ * @param const Graph& network: network, without removals
+ * @param const std::string& file: name of the snapshot file
+ * @param const std::vector<uint64_t>& hashes: hashFile() of the 4 files the network was parsed from
+ * @return bool: true if successful
+ * @note The file is written under a temporary name and then renamed, so a snapshot is never left half-written
+ * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+ */
+bool writeSnapshot(const Graph &network, const std::string &file, const std::vector<uint64_t> &hashes);
+
+/**
+ * @brief Loads a snapshot file into an empty network, if it matches the hashes and the algorithm of the network
+ * @param Graph& network: empty network, with the algorithm already selected, filled only if successful
+ * @param const std::string& file: name of the snapshot file
+ * @param const std::vector<uint64_t>& hashes: hashFile() of the 4 files the network would be parsed from
+ * @return bool: false if the file is missing, of another version or capacity type, stale or invalid
+ * @note The file is memory-mapped and fully validated before anything is added to the network
+ * @note The order of every adjacency and incoming vector is the same as after parsing, so the algorithms behave the same way
+ * @note Time Complexity: O(V + E), Space Complexity: O(V + E)
+ */
+bool loadSnapshot(Graph &network, const std::string &file, const std::vector<uint64_t> &hashes);
+
+#endif // SNAPSHOT_HPP
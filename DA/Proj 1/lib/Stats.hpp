@@ -0,0 +1,178 @@
+/**
+ * @file Stats.hpp
+ * @brief Declaration of the counters of the solvers and the timers of each phase
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+//! Counters added up over every run of the solvers
+enum stat_counter {
+    STAT_SEARCHES,          // BFSs/DFSs (for push-relabel, global relabellings)
+    STAT_ARCS_SCANNED,      // arcs looked at by the searches and by push-relabel
+    STAT_AUGMENTING_PATHS,  // paths the flow was pushed or reduced through
+    STAT_PATH_ARCS,         // arcs of those paths added up
+    STAT_ALLOCATIONS,       // residual arrays, flow states and arena blocks allocated
+    STAT_COUNTERS           // number of counters
+};
+
+//! Counters and wall-clock time of each phase (parse, max flow, dependency, each command), shared by every thread
+//! Building with -DNO_STATS compiles them out: the methods that record are then empty and inline, so nothing is paid
+class Stats {
+public:
+    /**
+     * @brief Tells whether the statistics were compiled in
+     * @return bool: false if built with -DNO_STATS
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    static bool enabled();
+
+#ifdef NO_STATS
+    static void add(stat_counter, uint64_t) {}
+    static void time(const std::string &, uint64_t) {}
+    static uint64_t get(stat_counter) { return 0; }
+#else
+    /**
+     * @brief Adds to a counter
+     * @param stat_counter counter: counter
+     * @param uint64_t amount: amount added
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    static void add(stat_counter counter, uint64_t amount);
+
+    /**
+     * @brief Adds one call and its wall-clock time to a phase
+     * @param const std::string& phase: name of the phase
+     * @param uint64_t nanoseconds: time of the call
+     * @return void
+     * @note Time Complexity: O(log p), p being the number of phases, Space Complexity: O(1)
+     */
+    static void time(const std::string &phase, uint64_t nanoseconds);
+
+    /**
+     * @brief Returns the value of a counter
+     * @param stat_counter counter: counter
+     * @return uint64_t: value, added over every thread
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    static uint64_t get(stat_counter counter);
+#endif
+
+    /**
+     * @brief Sets every counter and phase back to zero
+     * @return void
+     * @note Time Complexity: O(p), Space Complexity: O(1)
+     */
+    static void reset();
+
+    /**
+     * @brief Prints the counters, some averages and the time of each phase
+     * @param std::ostream& out: stream
+     * @return void
+     * @note Time Complexity: O(p), Space Complexity: O(p)
+     */
+    static void print(std::ostream &out);
+
+    /**
+     * @brief Writes the counters and the phases as JSON fields, each preceded by a comma
+     * @param std::ostream& fields: stream
+     * @return void
+     * @note The fields are "enabled", "counters" and "phases", which maps each phase to its "calls" and "seconds"
+     * @note Time Complexity: O(p), Space Complexity: O(p)
+     */
+    static void writeJson(std::ostream &fields);
+};
+
+//! Counters of one run of a solver: the hot loops only touch these local variables, which are added to Stats once, on destruction
+class SolverCounters {
+#ifdef NO_STATS
+public:
+    void search() {}
+    void scan() {}
+    void path(uint64_t) {}
+#else
+private:
+    uint64_t searches = 0, arcs = 0, paths = 0, pathArcs = 0;
+
+public:
+    SolverCounters() = default;
+    SolverCounters(const SolverCounters &) = delete;
+    SolverCounters &operator=(const SolverCounters &) = delete;
+
+    //! Counts a search
+    void search() { searches++; }
+
+    //! Counts an arc looked at
+    void scan() { arcs++; }
+
+    //! Counts a path of the given number of arcs
+    void path(uint64_t length) {
+        paths++;
+        pathArcs += length;
+    }
+
+    /**
+     * @brief Destructor, adds the counts to Stats
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    ~SolverCounters();
+#endif
+};
+
+//! Adds the wall-clock time from its construction to its destruction to a phase
+class PhaseTimer {
+#ifdef NO_STATS
+public:
+    explicit PhaseTimer(const char *) {}
+    PhaseTimer(const char *, const std::string &) {}
+    void discard() {}
+#else
+private:
+    const char *phase;                                      /*!< Name of the phase */
+    const std::string *name;                                /*!< Name of the command of the phase, nullptr if none */
+    std::chrono::steady_clock::time_point start;
+    bool discarded = false;
+
+public:
+    /**
+     * @brief Starts timing a phase
+     * @param const char* phase: name of the phase, which must outlive the timer
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    explicit PhaseTimer(const char *phase);
+
+    /**
+     * @brief Starts timing a named part of a phase, like a command, recorded as "phase:name"
+     * @param const char* phase: name of the phase
+     * @param const std::string& name: name of the part, which must outlive the timer
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    PhaseTimer(const char *phase, const std::string &name);
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+    /**
+     * @brief Leaves this call out of the phase, for example when the command is not valid
+     * @return void
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    void discard();
+
+    /**
+     * @brief Destructor, adds the time since the construction to the phase
+     * @note Time Complexity: the one of Stats::time(), Space Complexity: O(1)
+     */
+    ~PhaseTimer();
+#endif
+};
+
+#endif // STATS_HPP
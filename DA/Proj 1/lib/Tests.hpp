@@ -9,14 +9,21 @@
 #define TESTS_HPP
 
 #include "Graph.hpp"
+#include "Runtime.hpp"
+#include "Snapshot.hpp"
 #include "Vertex.hpp"
 #include "Edge.hpp"
 #include "Macros.hpp"
+#include "Stats.hpp"
 #include <iostream>
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <thread>
 
 //! Checks if the number of edges is correct
 void test_edges(Graph& g);
@@ -48,9 +55,48 @@ void test_remove_edges(Graph& g);
 //! Test how much the flow changes after a removal
 void test_flow_after_remove(Graph g);
 
+//! Checks if every maximum flow algorithm reaches the same flow, and how many iterations each one needs
+void test_max_flow_algorithms(Graph g);
+
+//! Checks that the flow paths add up to the water reaching each city, and that their estimates bound the exact loss of flow
+void test_path_index(Graph g);
+
+//! Checks that re-solving only the component of a removal reaches the same flow as solving the whole network
+void test_components(Graph g);
+
+//! Checks that the gain of every pipe upgrade, new pipe and new reservoir, evaluated from the current flow, matches the maximum flow calculated from scratch
+void test_upgrades(Graph g);
+
+//! Checks that the minimum cut carries the maximum flow, and that every city missing water is in a bottleneck
+void test_bottlenecks(Graph g);
+
+//! Checks that balancing lowers the utilization cost and keeps a valid flow with the same water reaching each city
+void test_balance(Graph g);
+
+//! Checks that the flow after removing each location, evaluated as a batch job, matches removing it from the network
+void test_removals(Graph g);
+
+//! Checks that the solver counters agree with the number of BFSs returned by Edmonds-Karp from scratch
+void test_stats(Graph g);
+
+//! Checks that the rankings of pairs of failures are the same on any number of threads, and that each pair takes more water than its members alone
+void test_k_failures(Graph g);
+
+//! Checks that two failure simulations with the same seed give the same deficits, whatever the number of threads
+void test_simulation(Graph g);
+
+//! Checks that respond(), called from several threads at the same time, gives the answers of query() called one command at a time
+void test_respond(Graph g);
+
+//! Checks that a snapshot loads into a fresh network equal to the one written, and that it is rejected once a CSV file changes or when cut short
+void test_snapshot(Graph g);
+
 //! Calculates some statistics
 void test_edge_statistics(Graph& g);
 
+//! Compares the dependency vectors calculated one City at a time with the ones of every City at once, and checks that a removal drops them from the cache
+void test_dependency(Graph g);
+
 //! Executes all tests
 void test_suite(Graph &g);
 
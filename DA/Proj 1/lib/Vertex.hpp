@@ -22,66 +22,38 @@ enum node_type {
     SINK            // The id of the Sink is 0
 };
 
+//! Data of a Vertex that only the commands read, kept by the Graph in a table apart from the vertexes
+struct VertexInfo {
+    std::string reservoir = "";                 /*!< Reservoir name in case it is a reservoir */
+    std::string municipality = "";              /*!< Municipality of the reservoir */
+    std::string city = "";                      /*!< City name in case it is a city */
+    unsigned int population = 0;                /*!< Population of the city */
+    std::vector<std::pair<Edge *, Capacity>> dependency; /*!< Pipes essential to a city and the deficit of water supply caused by its removal */
+};
+
 //! Cities, Reservoirs and Stations
+//! Only what the graph is walked by lives here; the names, the population and the dependencies are in a VertexInfo
 class Vertex {
 private:
-    double dist = 0;                            /*!< Auxiliary field for some algorithms */
-    bool visited = false;                       /*!< Auxiliary field for some algorithms */
-    Edge *path = nullptr;                       /*!< On a path, previous edge */
-
     std::vector<Edge *> adj;                    /*!< Outgoing edges */
     std::vector<Edge *> incoming;               /*!< Incoming edges */
 
-    std::vector<std::pair<Edge *, double>> dependency; /*!< Pipes essential to a city and the deficit of water supply caused by its removal */
-
+    VertexInfo *info;                           /*!< Cold data, owned by the Graph */
     node_type type;                             /*!< The vertex can be a City, a pumping Station or a Reservoir */
     unsigned int id;                            /*!< Each Vertex has an	unique ID */
-    std::string reservoir = "";                 /*!< Reservoir name in case it is a reservoir */
-    std::string municipality = "";              /*!< Municipality of the reservoir */
-    std::string city = "";                      /*!< City name in case it is a city */
-    unsigned int population = 0;                /*!< Population of the city */
+    unsigned int index = 0;                     /*!< Dense index given by its Graph: 0 for the Source, 1 for the Sink, then in creation order */
+
+    friend class Graph;
 public:
     /**
-     * @brief Constructor with a lot of attributes
+     * @brief Constructor
      * @param node_type type: specifies the type of the Vertex
      * @param unsigned int id: unique identifier
-     * @param const std::string reservoir = "": if a reservoir, its name
-     * @param const std::string municipality = "": if a reservoir, its municipality
-     * @param const std::string city = "": if a city, its name
-     * @param unsigned int population = 0: if a city, its population
+     * @param VertexInfo* info: names, population and dependencies, owned by the Graph
      * @note The city demand is present in its edge to the Sink
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    Vertex(node_type type,
-           unsigned int id,
-           const std::string reservoir = "",
-           const std::string municipality = "",
-           const std::string city = "",
-           unsigned int population = 0);
-
-    /**
-     * @brief Returns the distance, a.k.a. the maximum flow until that point in the path
-     * @return double: maximum flow until that point in the path
-     * @note Does not change attributes
-     * @note Time Complexity: O(1), Space Complexity: O(1)
-     */
-    double getDist() const;
-
-    /**
-     * @brief Returns whether the vertex was visited
-     * @return bool: whether the vertex was visited
-     * @note Does not change attributes
-     * @note Time Complexity: O(1), Space Complexity: O(1)
-     */
-    bool isVisited() const;
-
-    /**
-     * @brief Returns the previous edge in the path
-     * @return Edge*: previous edge in the path
-     * @note Does not change attributes
-     * @note Time Complexity: O(1), Space Complexity: O(1)
-     */
-    Edge *getPath() const;
+    Vertex(node_type type, unsigned int id, VertexInfo *info);
 
     /**
      * @brief Returns the outgoing edges
@@ -116,53 +88,35 @@ public:
 
     /**
      * @brief Returns the dependency vector
-     * @return const std::vector<std::pair<Edge*, double>>&: dependency vector
+     * @return const std::vector<std::pair<Edge*, Capacity>>&: dependency vector
      * @note Does not change attributes
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    const std::vector<std::pair<Edge *, double>> &getDependency() const;
+    const std::vector<std::pair<Edge *, Capacity>> &getDependency() const;
 
     /**
      * @brief Adds an edge to the dependency vector
      * @param Edge* e: pipe essential to the city
-     * @param double value: value of the pipe
-     * @return void
-     * @note Time Complexity: O(1), Space Complexity: O(1)
-     */
-    void addDependency(Edge *e, double value);
-
-    /**
-     * @brief Sets the distance, a.k.a. the maximum flow until that point in the path
-     * @param double dist: updated maximum flow
-     * @return void
-     * @note Time Complexity: O(1), Space Complexity: O(1)
-     */
-    void setDist(double dist);
-
-    /**
-     * @brief Sets whether the vertex was visited
-     * @param bool visited: whether the vertex was visited
+     * @param Capacity value: value of the pipe
      * @return void
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    void setVisited(bool visited);
+    void addDependency(Edge *e, Capacity value);
 
     /**
-     * @brief Sets the previous edge in the path
-     * @param Edge* path: previous edge in the path
+     * @brief Empties the dependency vector
      * @return void
-     * @note Time Complexity: O(1), Space Complexity: O(1)
+     * @note Time Complexity: O(n), n being the size of the vector, Space Complexity: O(1)
      */
-    void setPath(Edge *path);
+    void clearDependency();
 
     /**
-     * @brief Adds an edge
-     * @param Vertex* dest: destination
-     * @param double w: capacity of the edge
-     * @return Edge* : nullptr if not added
+     * @brief Adds an edge leaving this Vertex, to its outgoing edges and to the incoming edges of its destination
+     * @param Edge* e: edge whose origin is this Vertex, owned by the Graph
+     * @return Edge*: e
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    Edge *addEdge(Vertex *dest, double w);
+    Edge *addEdge(Edge *e);
 
     /**
      * @brief Removes an edge
@@ -188,6 +142,14 @@ public:
      */
     unsigned int getTypeId() const;
 
+    /**
+     * @brief Returns the dense index given by the Graph that created the Vertex
+     * @return unsigned int: index, smaller than Graph::getIndexCount(), also used by the residual graph
+     * @note Does not change attributes
+     * @note Time Complexity: O(1), Space Complexity: O(1)
+     */
+    unsigned int getIndex() const;
+
     /**
      * @brief Returns the code
      * @return std::string: code of the Vertex
@@ -238,19 +200,11 @@ public:
 
     /*
      * @brief Returns the demand of the city, if the Vertex is a city
-     * @return double: demand of the city
-     * @note Does not change attributes
-     * @note Time Complexity: O(1), Space Complexity: O(1)
-     */
-    double getDemand() const;
-
-    /**
-     * @brief Returns the previous Vertex in the path, if existent
-     * @return Vertex*: nullptr if not existent
+     * @return Capacity: demand of the city
      * @note Does not change attributes
      * @note Time Complexity: O(1), Space Complexity: O(1)
      */
-    Vertex *getPrevious() const;
+    Capacity getDemand() const;
 };
 
 #endif // VERTEX_HPP
@@ -0,0 +1,116 @@
+/**
+ * @file Components.cpp
+ * @brief Definition of class Components
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/Components.hpp"
+#include "../lib/Parallel.hpp"
+#include <numeric>
+#include <algorithm>
+
+const unsigned Components::NONE;
+
+//! Time Complexity: O(V + E * α(V)), Space Complexity: O(V + E)
+void Components::build(const ResidualGraph &r) {
+    const unsigned n = r.vertexCount();
+    std::vector<unsigned> root(n);
+    std::iota(root.begin(), root.end(), 0);
+    auto find = [&root](unsigned v) {
+        while (root[v] != v)
+            v = root[v] = root[root[v]];
+        return v;
+    };
+    for (unsigned a = 0; a < r.arcCount(); a++) {
+        unsigned u = r.getTail(a), v = r.getHead(a);
+        if (u == ResidualGraph::SOURCE_INDEX || u == ResidualGraph::SINK_INDEX ||
+            v == ResidualGraph::SOURCE_INDEX || v == ResidualGraph::SINK_INDEX)
+            continue;
+        u = find(u);
+        v = find(v);
+        if (u != v)
+            root[std::max(u, v)] = std::min(u, v); // the smallest vertex of each component is its root
+    }
+
+    parts.clear();
+    component.assign(n, NONE);
+    for (unsigned v = 2; v < n; v++) { // in increasing order, so each root is numbered before the rest of its component
+        unsigned c = find(v);
+        if (c == v) {
+            component[v] = parts.size();
+            parts.emplace_back();
+        } else {
+            component[v] = component[c];
+        }
+        parts[component[v]].vertexes.push_back(v);
+    }
+
+    std::vector<unsigned> local(n);
+    for (Part &p: parts)
+        p.graph.build(r, p.vertexes, local, p.arcs);
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned Components::count() const {
+    return parts.size();
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned Components::componentOf(unsigned v) const {
+    return component[v];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned Components::size(unsigned c) const {
+    return parts[c].vertexes.size();
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+std::vector<ResidualGraph::FlowState> Components::newStates() const {
+    std::vector<ResidualGraph::FlowState> states;
+    states.reserve(parts.size());
+    for (const Part &p: parts)
+        states.push_back(p.graph.newState());
+    return states;
+}
+
+//! Time Complexity: the one of the algorithm on the component, Space Complexity: O(1)
+unsigned Components::solve(const ResidualGraph &r, ResidualGraph::FlowState &s, unsigned c, max_flow_algorithm algorithm,
+                           std::vector<ResidualGraph::FlowState> &scratch) const {
+    const Part &p = parts[c];
+    ResidualGraph::FlowState &local = scratch[c]; // loadPart() overwrites everything the algorithm reads
+    p.graph.loadPart(local, s, p.arcs);
+    unsigned iterations = p.graph.maxFlow(local, algorithm);
+    r.storePart(s, local, p.arcs);
+    return iterations;
+}
+
+//! Time Complexity: the one of the algorithm on the largest component, plus O(V + E), Space Complexity: O(V + E)
+unsigned Components::solve(const ResidualGraph &r, ResidualGraph::FlowState &s, const std::vector<bool> &which,
+                           max_flow_algorithm algorithm, unsigned threads) const {
+    std::vector<unsigned> selected;
+    for (unsigned c = 0; c < parts.size(); c++)
+        if (which[c])
+            selected.push_back(c);
+
+    // the largest components go first, so that they do not start last and keep a single thread busy at the end
+    std::stable_sort(selected.begin(), selected.end(), [this](unsigned a, unsigned b) {
+        return parts[a].arcs.size() > parts[b].arcs.size();
+    });
+    std::vector<ResidualGraph::FlowState> flows(selected.size());
+    std::vector<unsigned> iterations(selected.size(), 0);
+    parallelFor(selected.size(), threads, [&](unsigned, unsigned i) {
+        const Part &p = parts[selected[i]];
+        flows[i] = p.graph.newState();
+        p.graph.loadPart(flows[i], s, p.arcs);
+        iterations[i] = p.graph.maxFlow(flows[i], algorithm);
+    });
+
+    unsigned total = 0;
+    for (unsigned i = 0; i < selected.size(); i++) {
+        r.storePart(s, flows[i], parts[selected[i]].arcs);
+        total += iterations[i];
+    }
+    return total;
+}
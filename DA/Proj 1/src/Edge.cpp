@@ -7,16 +7,20 @@
 
 #include "../lib/Edge.hpp"
 
-Edge::Edge(Vertex *orig, Vertex *dest, double w) : orig(orig), dest(dest), weight(w) {}
+Edge::Edge(Vertex *orig, Vertex *dest, Capacity w) : orig(orig), dest(dest), weight(w) {}
 
-double Edge::getFlow() const {
+Capacity Edge::getFlow() const {
     return flow;
 }
 
-double Edge::getWeight() const {
+Capacity Edge::getWeight() const {
     return this->weight;
 }
 
+unsigned Edge::getIndex() const {
+    return this->index;
+}
+
 Vertex *Edge::getOrig() const {
     return this->orig;
 }
@@ -25,6 +29,10 @@ Vertex *Edge::getDest() const {
     return this->dest;
 }
 
-void Edge::setFlow(double flow) {
+void Edge::setFlow(Capacity flow) {
     this->flow = flow;
 }
+
+void Edge::setWeight(Capacity weight) {
+    this->weight = weight;
+}
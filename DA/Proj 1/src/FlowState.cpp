@@ -0,0 +1,77 @@
+/**
+ * @file FlowState.cpp
+ * @brief Definition of class FlowState
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/FlowState.hpp"
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+template<typename Cap>
+BasicFlowState<Cap>::BasicFlowState(const BasicFlowState &other)
+    : flow(other.flow), removed(other.removed), parent(other.parent), visited(other.visited), queue(other.queue),
+      stamp(other.stamp) {}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+template<typename Cap>
+BasicFlowState<Cap> &BasicFlowState<Cap>::operator=(const BasicFlowState &other) {
+    flow = other.flow;
+    removed = other.removed;
+    parent = other.parent;
+    visited = other.visited;
+    queue = other.queue;
+    stamp = other.stamp;
+    journal.clear();
+    journaling = false;
+    return *this;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+Cap BasicFlowState<Cap>::getFlow(unsigned a) const {
+    return flow[a];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+const std::vector<Cap> &BasicFlowState<Cap>::getFlows() const {
+    return flow;
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+template<typename Cap>
+void BasicFlowState<Cap>::setFlows(const std::vector<Cap> &flows) {
+    flow = flows;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+bool BasicFlowState<Cap>::isRemoved(unsigned a) const {
+    return removed[a];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+const std::vector<unsigned char> &BasicFlowState<Cap>::getRemoved() const {
+    return removed;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+void BasicFlowState<Cap>::setJournaling(bool on) {
+    journaling = on;
+    if (!on)
+        journal.clear();
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+size_t BasicFlowState<Cap>::journalSize() const {
+    return journal.size();
+}
+
+// Every capacity type the residual graph is instantiated with
+template class BasicFlowState<double>;
+template class BasicFlowState<int64_t>;
+template class BasicFlowState<int32_t>;
@@ -6,91 +6,140 @@
 */
 
 #include "../lib/Graph.hpp"
+#include "../lib/Parallel.hpp"
+#include "../lib/Stats.hpp"
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+const unsigned Graph::NO_INDEX;
 
 Graph::Graph() {}
 
-Graph::Graph(const Graph &other) {
-    std::unordered_map<const Vertex *, Vertex *> translator;
-    for (std::pair<unsigned int, Vertex *> p: other.cityVertexes) {
-        Vertex *new_vertex = new Vertex(CITY, p.second->getId(), "", "", p.second->getCity(), p.second->getPopulation());
-        vertexSet.push_back(new_vertex);
-        cityVertexes.emplace(new_vertex->getTypeId(), new_vertex);
-        translator.emplace(p.second, new_vertex);
-    }
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+Graph::Graph(const Graph &other)
+        : source(nullptr), sink(nullptr), algorithm(other.algorithm), threads(other.threads) {
+    for (size_t i = 0; i < other.vertexArena.size(); i++)
+        vertexArena.create(*other.vertexArena[i]);
+    for (size_t i = 0; i < other.edgeArena.size(); i++)
+        edgeArena.create(*other.edgeArena[i]);
+    for (size_t i = 0; i < other.infoArena.size(); i++)
+        infoArena.create(*other.infoArena[i]);
 
-    for (std::pair<unsigned int, Vertex *> p: other.reservoirVertexes) {
-        Vertex *new_vertex = new Vertex(RESERVOIR, p.second->getId(), p.second->getReservoir(), p.second->getMunicipality(), "", 0);
-        vertexSet.push_back(new_vertex);
-        reservoirVertexes.emplace(new_vertex->getTypeId(), new_vertex);
-        translator.emplace(p.second, new_vertex);
+    // The copies still point to the vertexes and edges of other, which have the same indexes here
+    auto vertex = [&](const Vertex *v) { return v == nullptr ? nullptr : vertexArena[other.vertexArena.indexOf(v)]; };
+    auto edge = [&](const Edge *e) { return e == nullptr ? nullptr : edgeArena[other.edgeArena.indexOf(e)]; };
+    for (size_t i = 0; i < vertexArena.size(); i++) {
+        Vertex *v = vertexArena[i];
+        v->info = infoArena[i];
+        for (Edge *&e: v->adj)
+            e = edge(e);
+        for (Edge *&e: v->incoming)
+            e = edge(e);
+        for (std::pair<Edge *, Capacity> &d: v->info->dependency)
+            d.first = edge(d.first);
     }
-
-    for (std::pair<unsigned int, Vertex *> p: other.stationVertexes) {
-        Vertex *new_vertex = new Vertex(STATION, p.second->getId(), "", "", "", 0);
-        vertexSet.push_back(new_vertex);
-        stationVertexes.emplace(new_vertex->getTypeId(), new_vertex);
-        translator.emplace(p.second, new_vertex);
+    for (size_t i = 0; i < edgeArena.size(); i++) {
+        Edge *e = edgeArena[i];
+        e->orig = vertex(e->orig);
+        e->dest = vertex(e->dest);
     }
 
-    translator.emplace(other.sink, sink);
-    translator.emplace(other.source, source);
+    source = vertex(other.source);
+    sink = vertex(other.sink);
+    for (unsigned t = 0; t < 3; t++)
+        codeIndexes[t] = other.codeIndexes[t];
+    for (const Vertex *v: other.vertexSet)
+        vertexSet.push_back(vertex(v));
+    for (std::pair<unsigned int, Vertex *> p: other.cityVertexes)
+        cityVertexes.emplace(p.first, vertex(p.second));
+    for (std::pair<unsigned int, Vertex *> p: other.reservoirVertexes)
+        reservoirVertexes.emplace(p.first, vertex(p.second));
+    for (std::pair<unsigned int, Vertex *> p: other.stationVertexes)
+        stationVertexes.emplace(p.first, vertex(p.second));
+    for (const Vertex *v: other.removedVertexes)
+        removedVertexes.push_back(vertex(v));
+    for (const Edge *e: other.removedEdges)
+        removedEdges.push_back(edge(e));
 
-    for (Vertex *v: other.vertexSet) {
-        Vertex *new_vertex = translator[v];
-        for (Edge *e: v->getAdj()) {
-            Vertex *dest = translator[e->getDest()];
-            Edge *new_edge = new_vertex->addEdge(dest, e->getWeight());
-            new_edge->setFlow(e->getFlow());
-        }
-    }
+    // the arrays are rebuilt with the same arcs, so the cached dependency vectors stay valid until the flow changes
+    dependencyKnown = other.dependencyKnown;
+    dependencyFlows = other.dependencyFlows;
+    dependencyRemoved = other.dependencyRemoved;
+    dependencyCapacities = other.dependencyCapacities;
+}
 
-    for (Edge *e: other.source->getAdj()) {
-        Edge *new_edge = this->source->addEdge(translator[e->getDest()], e->getWeight());
-        new_edge->setFlow(e->getFlow());
-    }
+//! Time Complexity: O(1) amortized, Space Complexity: O(1)
+Vertex *Graph::createVertex(node_type type, unsigned int id, const std::string reservoir,
+                            const std::string municipality, const std::string city, unsigned int population) {
+    VertexInfo *info = infoArena.create();
+    info->reservoir = reservoir;
+    info->municipality = municipality;
+    info->city = city;
+    info->population = population;
+    Vertex *v = vertexArena.create(type, id, info);
+    v->index = vertexArena.size() - 1;
+    return v;
+}
 
-    for (std::pair<unsigned int, Vertex *> p: other.cityVertexes) {
-        for (auto d: p.second->getDependency()) {
-            translator[p.second]->addDependency(this->findEdge(translator[d.first->getOrig()], translator[d.first->getDest()]), d.second);
-        }
-    }
+//! Time Complexity: O(1) amortized, Space Complexity: O(1)
+Edge *Graph::createEdge(Vertex *orig, Vertex *dest, Capacity w) {
+    Edge *e = edgeArena.create(orig, dest, w);
+    e->index = edgeArena.size() - 1;
+    return e;
 }
 
+//! Time Complexity: O(1), Space Complexity: O(1)
 Vertex *Graph::findVertex(unsigned int id) const {
-    for (Vertex *v: this->vertexSet) {
-        if (v->getId() == id)
-            return v;
+    switch (id % 10) { // The last number of the ID yields the type
+        case 1: return findVertex(CITY, id / 10);
+        case 2: return findVertex(RESERVOIR, id / 10);
+        case 3: return findVertex(STATION, id / 10);
+        default: return nullptr;
     }
-    return nullptr;
 }
 
-Vertex *Graph::findVertex(const std::string &code) {
+//! Time Complexity: O(1), Space Complexity: O(1)
+Vertex *Graph::findVertex(const std::string &code) const {
     if (code.size() < 3)
         return nullptr;
+    node_type type;
+    size_t digits;
     switch (code[0]) {
-        case 'P': {
-            auto itr = stationVertexes.find(atoi(code.substr(3).c_str()));
-            if (itr == stationVertexes.end())
-                return nullptr;
-            return itr->second;
-        }
-        case 'R': {
-            auto itr = reservoirVertexes.find(atoi(code.substr(2).c_str()));
-            if (itr == reservoirVertexes.end())
-                return nullptr;
-            return itr->second;
-        }
-        case 'C': {
-            auto itr = cityVertexes.find(atoi(code.substr(2).c_str()));
-            if (itr == cityVertexes.end())
-                return nullptr;
-            return itr->second;
-        }
+        case 'P': type = STATION; digits = 3; break;
+        case 'R': type = RESERVOIR; digits = 2; break;
+        case 'C': type = CITY; digits = 2; break;
+        default: return nullptr;
     }
-    return nullptr;
+    unsigned typeId = 0;
+    for (size_t i = digits; i < code.size() && code[i] >= '0' && code[i] <= '9' && typeId < NO_INDEX / 10; i++)
+        typeId = typeId * 10 + (code[i] - '0');
+    return findVertex(type, typeId);
 }
 
-Edge *Graph::findEdge(Vertex *src, Vertex *dst) {
+//! Time Complexity: O(1), Space Complexity: O(1)
+Vertex *Graph::findVertex(node_type type, unsigned int typeId) const {
+    if (type > STATION || typeId >= codeIndexes[type].size() || codeIndexes[type][typeId] == NO_INDEX)
+        return nullptr;
+    return vertexArena[codeIndexes[type][typeId]];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+Vertex *Graph::getVertex(unsigned index) const {
+    return vertexArena[index];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned Graph::getIndexCount() const {
+    return vertexArena.size();
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned Graph::getEdgeIndexCount() const {
+    return edgeArena.size();
+}
+
+Edge *Graph::findEdge(Vertex *src, Vertex *dst) const {
     if (src == nullptr || dst == nullptr)
         return nullptr;
     for (Edge *e: src->getAdj())
@@ -100,7 +149,19 @@ Edge *Graph::findEdge(Vertex *src, Vertex *dst) {
 }
 
 bool Graph::addVertex(Vertex *v) {
+    residualUpToDate = false;
+    checkpoints.clear();
+    return insertVertex(v);
+}
+
+bool Graph::insertVertex(Vertex *v) {
     this->vertexSet.push_back(v);
+    if (v->getType() <= STATION) {
+        std::vector<unsigned> &indexes = codeIndexes[v->getType()];
+        if (indexes.size() <= v->getTypeId())
+            indexes.resize(v->getTypeId() + 1, NO_INDEX);
+        indexes[v->getTypeId()] = v->getIndex();
+    }
     switch (v->getType()) {
         case CITY:
             cityVertexes.insert(std::make_pair(v->getTypeId(), v));
@@ -117,119 +178,270 @@ bool Graph::addVertex(Vertex *v) {
     return true;
 }
 
-unsigned Graph::reduceFlow(Vertex *src, Vertex *dst, double limit) const {
-    unsigned BFSes = 1; // there is always at least one BFS
-    reduceFlowLoop:
-    while (limit > 0) {
-        this->setAllVisitedFalse();
-        src->setVisited(true);
-
-        std::queue<Vertex *> q;
-        q.push(src);
-
-        while (true) { // BFS
-            Vertex *v = q.front();
-            q.pop();
-
-            for (Edge *e: v->getAdj()) {
-                Vertex *d = e->getDest();
-                if (!d->isVisited() && e->getFlow() > 0) {
-                    d->setPath(e);
-                    if (d != dst) {
-                        d->setVisited(true);
-                        q.push(d);
-                    } else {
-                        double min = limit;
-                        for (Vertex *aux = dst; aux != src; aux = aux->getPrevious())
-                            min = std::min(min, aux->getPath()->getFlow());
-                        for (Vertex *aux = dst; aux != src; aux = aux->getPrevious())
-                            aux->getPath()->setFlow(aux->getPath()->getFlow() - min);
-                        limit -= min;
-                        ++BFSes;
-                        goto reduceFlowLoop;
-                    }
-                }
-            }
-            if (q.empty())
-                return BFSes;
-        } // BFS
-    } // external loop
+unsigned Graph::reduceFlow(Vertex *src, Vertex *dst, Capacity limit) const {
+    const ResidualGraph &r = getResidual();
+    unsigned BFSes = r.reduceFlow(state, r.indexOf(src), r.indexOf(dst), limit);
+    // the reduced paths never go through the source nor the sink, so they stay in the component of src or dst
+    unsigned c = components.componentOf(r.indexOf(src)) != Components::NONE ? components.componentOf(r.indexOf(src))
+                                                                            : components.componentOf(r.indexOf(dst));
+    if (c == Components::NONE)
+        unsolved.assign(components.count(), true);
+    else
+        unsolved[c] = true;
+    r.store(state);
     return BFSes;
 }
 
+//! Time Complexity: the one of removeVertex(Vertex*), Space Complexity: O(1)
 bool Graph::removeVertex(unsigned int id, unsigned *iterations) {
-    for (std::vector<Vertex *>::iterator itr = this->vertexSet.begin(); itr != this->vertexSet.end(); ++itr) {
-        if ((*itr)->getId() == id) {
-            Vertex *to_remove = *itr;
-            unsigned augmentingPaths = reduceFlow(source, to_remove, INF);
-            augmentingPaths += reduceFlow(to_remove, sink, INF);
-            if (iterations != nullptr)
-                *iterations = augmentingPaths;
-            for (Edge *e: to_remove->getAdj()) { // Erasing the edges from the incoming vector of the adjacent vertexes
-                Vertex *a = e->getDest();
-                for (std::vector<Edge *>::iterator s = a->getIncoming().begin(); s < a->getIncoming().end(); s++) {
-                    if ((*s)->getOrig() == to_remove) {
-                        a->getIncoming().erase(s);
-                        break;
-                    }
-                }
-                removedEdges.push_back(e);
-            }
-            for (Edge *e: to_remove->getIncoming()) { // Erasing the edges from the adjacent vector of the incoming vertexes
-                Vertex *a = e->getOrig();
-                for (std::vector<Edge *>::iterator s = a->getAdj().begin(); s < a->getAdj().end(); s++) {
-                    if ((*s)->getDest() == to_remove) {
-                        a->getAdj().erase(s);
-                        break;
-                    }
-                }
-                removedEdges.push_back(e);
+    return removeVertex(findVertex(id), iterations);
+}
+
+//! Time Complexity: O(V + E) plus two flow reductions, Space Complexity: O(1)
+bool Graph::removeVertex(Vertex *to_remove, unsigned *iterations) {
+    if (to_remove == nullptr || findVertex(to_remove->getType(), to_remove->getTypeId()) != to_remove)
+        return false;
+    unsigned augmentingPaths = reduceFlow(source, to_remove, INF);
+    augmentingPaths += reduceFlow(to_remove, sink, INF);
+    if (iterations != nullptr)
+        *iterations = augmentingPaths;
+    const ResidualGraph &r = getResidual(); // the arcs are cut, not rebuilt, so snapshots stay comparable
+    unsolved[components.componentOf(r.indexOf(to_remove))] = true;
+    for (Edge *e: to_remove->getAdj())
+        r.cutArc(state, r.arcOf(e));
+    for (Edge *e: to_remove->getIncoming())
+        r.cutArc(state, r.arcOf(e));
+    r.store(state);
+    for (Edge *e: to_remove->getAdj()) { // Erasing the edges from the incoming vector of the adjacent vertexes
+        Vertex *a = e->getDest();
+        for (std::vector<Edge *>::iterator s = a->getIncoming().begin(); s < a->getIncoming().end(); s++) {
+            if ((*s)->getOrig() == to_remove) {
+                a->getIncoming().erase(s);
+                break;
             }
-            to_remove->getAdj().clear();
-            to_remove->getIncoming().clear();
-            itr = this->vertexSet.erase(itr);
-            switch (id % 10) {
-                case 1:
-                    this->cityVertexes.erase(to_remove->getTypeId());
-                    break;
-                case 2:
-                    this->reservoirVertexes.erase(to_remove->getTypeId());
-                    break;
-                case 3:
-                    this->stationVertexes.erase(to_remove->getTypeId());
-                    break;
-                default:
-                    return false;
+        }
+        removedEdges.push_back(e);
+    }
+    for (Edge *e: to_remove->getIncoming()) { // Erasing the edges from the adjacent vector of the incoming vertexes
+        Vertex *a = e->getOrig();
+        for (std::vector<Edge *>::iterator s = a->getAdj().begin(); s < a->getAdj().end(); s++) {
+            if ((*s)->getDest() == to_remove) {
+                a->getAdj().erase(s);
+                break;
             }
-            removedVertexes.push_back(to_remove);
-            return true;
         }
+        removedEdges.push_back(e);
     }
-    return false;
+    to_remove->getAdj().clear();
+    to_remove->getIncoming().clear();
+    vertexSet.erase(std::find(vertexSet.begin(), vertexSet.end(), to_remove));
+    codeIndexes[to_remove->getType()][to_remove->getTypeId()] = NO_INDEX;
+    switch (to_remove->getType()) {
+        case CITY:
+            this->cityVertexes.erase(to_remove->getTypeId());
+            break;
+        case RESERVOIR:
+            this->reservoirVertexes.erase(to_remove->getTypeId());
+            break;
+        default:
+            this->stationVertexes.erase(to_remove->getTypeId());
+    }
+    removedVertexes.push_back(to_remove);
+    return true;
 }
 
-Edge *Graph::addEdge(unsigned int source, unsigned int dest, double w) {
+Edge *Graph::addEdge(unsigned int source, unsigned int dest, Capacity w) {
     Vertex *v1 = this->findVertex(source), *v2 = this->findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return nullptr;
-    return v1->addEdge(v2, w);
+    return addEdge(v1, v2, w);
+}
+
+//! Time Complexity: O(1) amortized, Space Complexity: O(1)
+Edge *Graph::addEdge(Vertex *orig, Vertex *dest, Capacity w) {
+    Edge *e = createEdge(orig, dest, w);
+    addEdge(e);
+    return e;
+}
+
+//! Time Complexity: O(1) amortized, Space Complexity: O(1)
+void Graph::addEdge(Edge *e) {
+    residualUpToDate = false;
+    checkpoints.clear();
+    e->getOrig()->addEdge(e);
 }
 
 bool Graph::removeEdge(Vertex *src, Vertex *dest, unsigned *iterations) {
     if (src == nullptr || dest == nullptr)
         return false;
+    const ResidualGraph &r = getResidual(); // built before unlinking, so it still has the arc of the edge
     Edge *to_remove = src->removeEdge(dest);
     if (to_remove == nullptr)
         return false;
-    double flow = to_remove->getFlow();
-    unsigned augmentingPaths = reduceFlow(this->getSource(), src, flow);
-    augmentingPaths += reduceFlow(dest, this->getSink(), flow);
+    unsigned augmentingPaths = r.cutArc(state, r.arcOf(to_remove));
+    unsolved[components.componentOf(r.indexOf(src))] = true;
+    r.store(state);
     if (iterations != nullptr)
         *iterations = augmentingPaths;
     removedEdges.push_back(to_remove);
     return true;
 }
 
+//! Time Complexity: O(c), Space Complexity: O(1)
+bool Graph::isSolved() const {
+    return residualUpToDate && std::find(unsolved.begin(), unsolved.end(), true) == unsolved.end();
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+void Graph::rebuildAround(Vertex *v, bool solved) {
+    const ResidualGraph &r = getResidual(); // the flow of the edges is loaded into the new arrays
+    if (solved) {
+        unsolved.assign(components.count(), false);
+        if (v != nullptr)
+            unsolved[components.componentOf(r.indexOf(v))] = true;
+    }
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+bool Graph::upgradePipe(Edge *e, Capacity capacity) {
+    Vertex *orig = e->getOrig();
+    if (orig == source || e->getDest() == sink || capacity < e->getWeight() ||
+        std::find(orig->getAdj().begin(), orig->getAdj().end(), e) == orig->getAdj().end())
+        return false;
+    bool solved = isSolved();
+    e->setWeight(capacity); // the flow is still below the capacity, so it stays valid
+    residualUpToDate = false;
+    checkpoints.clear();
+    rebuildAround(orig, solved);
+    return true;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+Edge *Graph::addPipe(Vertex *orig, Vertex *dest, Capacity capacity) {
+    if (orig == nullptr || dest == nullptr || orig == dest ||
+        findVertex(orig->getType(), orig->getTypeId()) != orig || findVertex(dest->getType(), dest->getTypeId()) != dest ||
+        findEdge(orig, dest) != nullptr)
+        return nullptr;
+    bool solved = isSolved();
+    Edge *e = addEdge(orig, dest, capacity);
+    rebuildAround(orig, solved); // the pipe may join two components, orig is in the joined one
+    return e;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+Vertex *Graph::addReservoir(unsigned typeId, const std::string &name, Capacity delivery) {
+    if (typeId >= NO_INDEX / 10 || findVertex(RESERVOIR, typeId) != nullptr)
+        return nullptr;
+    for (Vertex *v: removedVertexes)
+        if (v->getType() == RESERVOIR && v->getTypeId() == typeId)
+            return nullptr;
+    bool solved = isSolved();
+    Vertex *v = createVertex(RESERVOIR, typeId * 10 + 2, name);
+    addVertex(v);
+    addEdge(source, v, delivery);
+    rebuildAround(nullptr, solved); // without pipes, its water cannot go anywhere
+    return v;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+bool Graph::applyUpgrade(const Upgrade &upgrade) {
+    switch (upgrade.type) {
+        case UPGRADE_PIPE: {
+            Edge *e = findEdge(upgrade.orig, upgrade.dest);
+            return e != nullptr && upgradePipe(e, upgrade.capacity);
+        }
+        case ADD_PIPE:
+            return addPipe(upgrade.orig, upgrade.dest, upgrade.capacity) != nullptr;
+        case ADD_RESERVOIR: {
+            // the destination is checked first, so that a reservoir is never added without its pipe
+            if (upgrade.dest == nullptr || findVertex(upgrade.dest->getType(), upgrade.dest->getTypeId()) != upgrade.dest)
+                return false;
+            Vertex *v = addReservoir(upgrade.reservoir, "R_" + std::to_string(upgrade.reservoir), upgrade.delivery);
+            return v != nullptr && addPipe(v, upgrade.dest, upgrade.capacity) != nullptr;
+        }
+    }
+    return false;
+}
+
+//! Time Complexity: O(V + E + n * (V + E + F)), Space Complexity: O(threads * (V + E + n) + n * C)
+std::vector<UpgradeReport> Graph::evaluateUpgrades(const std::vector<Upgrade> &candidates) const {
+    const ResidualGraph &r = getResidual();
+    const FlowState base = state;
+
+    // every candidate adds arcs to one residual graph, cut until its turn: an upgraded pipe gets a parallel arc with the extra capacity,
+    // and a new reservoir a vertex of its own with an arc from the source
+    auto live = [this](const Vertex *v) { return v != nullptr && findVertex(v->getType(), v->getTypeId()) == v; };
+    std::vector<UpgradeReport> reports(candidates.size());
+    std::vector<std::pair<unsigned, unsigned>> added;
+    std::vector<Capacity> capacities;
+    std::vector<unsigned> firstAdded(candidates.size() + 1, 0); // the arcs of candidate i are [firstAdded[i], firstAdded[i + 1])
+    unsigned vertexes = 0;
+    for (unsigned i = 0; i < candidates.size(); i++) {
+        const Upgrade &u = candidates[i];
+        switch (u.type) {
+            case UPGRADE_PIPE: {
+                Edge *e = findEdge(u.orig, u.dest);
+                if (e == nullptr || u.orig == source || u.dest == sink || u.capacity < e->getWeight())
+                    break;
+                reports[i].applied = true;
+                added.emplace_back(r.indexOf(u.orig), r.indexOf(u.dest));
+                capacities.push_back(u.capacity - e->getWeight());
+                break;
+            }
+            case ADD_PIPE:
+                if (!live(u.orig) || !live(u.dest) || u.orig == u.dest || findEdge(u.orig, u.dest) != nullptr)
+                    break;
+                reports[i].applied = true;
+                added.emplace_back(r.indexOf(u.orig), r.indexOf(u.dest));
+                capacities.push_back(u.capacity);
+                break;
+            case ADD_RESERVOIR: {
+                bool taken = u.reservoir >= NO_INDEX / 10 || findVertex(RESERVOIR, u.reservoir) != nullptr;
+                for (Vertex *v: removedVertexes)
+                    taken |= v->getType() == RESERVOIR && v->getTypeId() == u.reservoir;
+                if (!live(u.dest) || taken)
+                    break;
+                reports[i].applied = true;
+                unsigned v = r.vertexCount() + vertexes++;
+                added.emplace_back(r.indexOf(source), v);
+                capacities.push_back(u.delivery);
+                added.emplace_back(v, r.indexOf(u.dest));
+                capacities.push_back(u.capacity);
+                break;
+            }
+        }
+        firstAdded[i + 1] = added.size();
+    }
+    ResidualGraph extended;
+    std::vector<unsigned> arcMap;
+    extended.build(r, vertexes, added, capacities, arcMap);
+    FlowState start = extended.newState();
+    extended.loadBase(start, r, base);
+
+    std::vector<std::pair<Vertex *, unsigned>> cities; // each city and its arc to the sink in the extended graph
+    for (auto p: cityVertexes)
+        cities.emplace_back(p.second, extended.arcOfBase(r, r.arcOf(p.second->getAdj()[0])));
+    std::vector<FlowState> workers(workerCount(candidates.size(), threads), start);
+    parallelFor(candidates.size(), threads, [&](unsigned worker, unsigned i) {
+        UpgradeReport &report = reports[i];
+        if (!report.applied)
+            return;
+        FlowState &s = workers[worker];
+        s = start; // also cuts the arcs of the previous candidate again
+        for (unsigned a = firstAdded[i]; a < firstAdded[i + 1]; a++)
+            extended.restoreArc(s, arcMap[a]);
+        extended.maxFlow(s, algorithm);
+
+        for (const std::pair<Vertex *, unsigned> &c: cities) {
+            Capacity gain = s.getFlow(c.second) - start.getFlow(c.second);
+            if (gain > 0)
+                report.gain[c.first] = gain;
+            report.total += gain;
+        }
+    });
+    return reports;
+}
+
 const std::vector<Vertex *> &Graph::getVertexSet() const {
     return this->vertexSet;
 }
@@ -242,40 +454,23 @@ Vertex *Graph::getSink() const {
     return this->sink;
 }
 
-double Graph::getFlow() const {
-    double flow = 0;
+Capacity Graph::getFlow() const {
+    Capacity flow = 0;
     for (auto p: this->getCityVertexes()) // C++17: for (auto [_, v] : this->getCityVertexes())
         flow += p.second->getAdj()[0]->getFlow();
     return flow;
 }
 
-double Graph::getFlowFromSource() const {
-    double flow = 0;
+Capacity Graph::getFlowFromSource() const {
+    Capacity flow = 0;
     for (Edge *e: source->getAdj())
         flow += e->getFlow();
     return flow;
 }
 
-Graph::~Graph() {
-    for (Vertex *v: this->vertexSet) {
-        for (Edge *e: v->getAdj())
-            delete e;
-        delete v;
-    }
-    for (Vertex *v: this->removedVertexes) {
-        for (Edge *e: v->getAdj())
-            delete e;
-        for (Edge *e: v->getIncoming())
-            delete e;
-        delete v;
-    }
-    for (Edge *e: removedEdges)
-        delete e;
-    for (Edge *e: this->source->getAdj())
-        delete e;
-    delete this->source;
-    delete this->sink;
-}
+//! The arenas own every Vertex and Edge, removed ones included
+//! Time Complexity: O(V), Space Complexity: O(1)
+Graph::~Graph() {}
 
 const std::unordered_map<unsigned int, Vertex *> &Graph::getCityVertexes() const {
     return this->cityVertexes;
@@ -289,141 +484,228 @@ const std::unordered_map<unsigned int, Vertex *> &Graph::getStationVertexes() co
     return this->stationVertexes;
 }
 
-void Graph::setAllVisitedFalse() const {
-    for (Vertex *v: vertexSet)
-        v->setVisited(false);
-    source->setVisited(true);
-    sink->setVisited(false);
+const ResidualGraph &Graph::getResidual() const {
+    if (!residualUpToDate) {
+        residual.build(*this);
+        state = residual.newState();
+        residualUpToDate = true;
+        pathsUpToDate = false;
+        components.build(residual);
+        unsolved.assign(components.count(), true);
+    }
+    residual.load(state);
+    return residual;
 }
 
-unsigned Graph::edmondsKarp() {
-    // to start from scratch, reset all flows before running
-    unsigned iterations = 0;
-    edmondsKarpLoop: // label avoids creating a bool to break out of the BFS
-    ++iterations;
-    this->setAllVisitedFalse();
-
-    std::queue<Vertex *> q;
-    q.push(this->source);
-    while (true) {
-        while (!q.empty()) { // BFS
-            Vertex *v = q.front();
-            q.pop();
-
-            for (Edge *e: v->getAdj()) { // outgoing edges
-                Vertex *d = e->getDest();
-                if (!d->isVisited() && e->getFlow() < e->getWeight()) {
-                    d->setPath(e);
-                    if (d != this->sink) {
-                        d->setVisited(true);
-                        q.push(d);
-                    } else {
-                        double min = INF; // maximum flow that can go through the path found
-                        for (Vertex *aux = this->sink; aux != this->source; aux = aux->getPrevious()) {
-                            Edge *path = aux->getPath();
-                            min = std::min(min, aux == path->getDest() ? path->getWeight() - path->getFlow()
-                                                                       : path->getFlow());
-                        }
-                        for (Vertex *aux = this->sink; aux != this->source; aux = aux->getPrevious()) {
-                            Edge *path = aux->getPath();
-                            path->setFlow(path->getFlow() + (aux == path->getDest() ? min : -min));
-                        }
-                        goto edmondsKarpLoop;
-                    }
-                }
-            } // outgoing edges
-
-            for (Edge *e: v->getIncoming()) { // incoming edges
-                Vertex *d = e->getOrig();
-                if (!d->isVisited() && e->getFlow() > 0) {
-                    d->setVisited(true);
-                    d->setPath(e);
-                    q.push(d);
-                }
-            } // incoming edges
-        }
-        if (q.empty())
-            return iterations;
+FlowState Graph::getState() const {
+    getResidual();
+    return state;
+}
+
+Capacity Graph::getEdgeFlow(const FlowState &scenario, const Edge *e) const {
+    return scenario.getFlow(residual.arcOf(e));
+}
+
+//! Time Complexity: O(E) if up to date, O(P * V + E) otherwise, Space Complexity: O(P * V + E)
+const PathIndex &Graph::getPathIndex() const {
+    const ResidualGraph &r = getResidual();
+    if (!pathsUpToDate || !paths.matches(state)) {
+        paths.build(r, state);
+        pathsUpToDate = true;
     }
+    return paths;
 }
 
-double Graph::fordFulkerson() {
-    for (Vertex *v: this->getVertexSet()) {
-        for (Edge *e: v->getAdj())
-            e->setFlow(0); // Setting the flow of all the edges as 0.
+/**
+ * @brief Gathers the paths through some arcs by City
+ * @param const Graph& g: network
+ * @param const ResidualGraph& r: arrays of the network
+ * @param const PathIndex& index: paths of the current flow
+ * @param const std::vector<unsigned>& arcs: arcs that fail together
+ * @return FailureEstimate: paths through those arcs, by City
+ * @note Auxiliary function of Graph::estimateFailure()
+ * @note Time Complexity: O(k * log k), k being the number of paths through the arcs, Space Complexity: O(k)
+ */
+static FailureEstimate estimateArcs(const Graph &g, const ResidualGraph &r, const PathIndex &index,
+                                    const std::vector<unsigned> &arcs) {
+    FailureEstimate estimate;
+    for (unsigned p: index.pathsThrough(arcs)) {
+        estimate.deficit[g.getVertex(r.getTail(index.getCityArc(p)))] += index.getAmount(p);
+        estimate.total += index.getAmount(p);
+        estimate.paths++;
     }
+    return estimate;
+}
+
+//! Time Complexity: O(E + k * log k), Space Complexity: O(k)
+FailureEstimate Graph::estimateFailure(Vertex *v) const {
+    const PathIndex &index = getPathIndex(); // also brings the arrays up to date
+    std::vector<unsigned> arcs;
+    for (Edge *e: v->getIncoming())
+        arcs.push_back(residual.arcOf(e));
+    for (Edge *e: v->getAdj())
+        arcs.push_back(residual.arcOf(e));
+    return estimateArcs(*this, residual, index, arcs);
+}
 
-    double totalFlow = 0;
-    bool found = false;
-    double flow = 0;
-    std::vector<Edge *> toIncreaseFlow;
-    std::vector<Edge *> toDecreaseFlow;
+//! Time Complexity: O(E + k * log k), Space Complexity: O(k)
+FailureEstimate Graph::estimateFailure(Edge *e) const {
+    const PathIndex &index = getPathIndex();
+    return estimateArcs(*this, residual, index, {residual.arcOf(e)});
+}
 
-    do {
-        totalFlow += flow;
-        for (Edge *e: toIncreaseFlow) e->setFlow(e->getFlow() + flow); // Update flow (increase)
-        for (Edge *e: toDecreaseFlow) e->setFlow(e->getFlow() - flow); // Update flow (decrease)
+//! Time Complexity: O(V + E * α(V)), Space Complexity: O(V + E)
+std::vector<Bottleneck> Graph::bottlenecks() const {
+    const ResidualGraph &r = getResidual();
+    std::vector<bool> sourceSide;
+    std::vector<unsigned> cut = r.minCut(state, sourceSide);
 
-        toIncreaseFlow = {};
-        toDecreaseFlow = {};
-        flow = INF;
-        found = false;  // Resetting values
+    // regions of the vertexes behind the cut, joined by pipes, the source and the sink left out
+    const unsigned n = r.vertexCount();
+    std::vector<unsigned> root(n);
+    for (unsigned v = 0; v < n; v++)
+        root[v] = v;
+    auto find = [&root](unsigned v) {
+        while (root[v] != v)
+            v = root[v] = root[root[v]];
+        return v;
+    };
+    auto behind = [&](unsigned v) {
+        return !sourceSide[v] && v != ResidualGraph::SINK_INDEX;
+    };
+    for (unsigned a = 0; a < r.arcCount(); a++) {
+        unsigned u = r.getTail(a), v = r.getHead(a);
+        if (r.getEdge(a) != nullptr && !state.isRemoved(a) && behind(u) && behind(v))
+            root[find(u)] = find(v);
+    }
 
-        for (Vertex *v: this->getVertexSet()) v->setVisited(false); // Set all vertexes as non visited.
+    std::vector<unsigned> group(n, NO_INDEX);
+    std::vector<Bottleneck> result;
+    auto groupOf = [&](unsigned v) -> Bottleneck & {
+        unsigned &g = group[find(v)];
+        if (g == NO_INDEX) {
+            g = result.size();
+            result.emplace_back();
+        }
+        return result[g];
+    };
+    for (unsigned a: cut) {
+        if (r.getHead(a) == ResidualGraph::SINK_INDEX)
+            continue; // a City on the source side gets all it asks for
+        Bottleneck &b = groupOf(r.getHead(a));
+        b.pipes.push_back(r.getEdge(a));
+        b.capacity += r.getCapacity(a);
+    }
+    std::vector<Vertex *> cities;
+    for (auto p: cityVertexes)
+        cities.push_back(p.second);
+    std::sort(cities.begin(), cities.end(), [](Vertex *a, Vertex *b) { return a->getTypeId() < b->getTypeId(); });
+    for (Vertex *c: cities) {
+        Edge *e = c->getAdj()[0];
+        if (e->getFlow() >= e->getWeight())
+            continue;
+        Bottleneck &b = groupOf(r.indexOf(c));
+        b.cities.push_back(c);
+        b.missing += e->getWeight() - e->getFlow();
+    }
 
-        recursiveAugmentingPath(this->source, toIncreaseFlow, toDecreaseFlow, flow, found); // Try to find path
-    } while (found);
+    result.erase(std::remove_if(result.begin(), result.end(), [](const Bottleneck &b) { return b.cities.empty(); }), result.end());
+    std::stable_sort(result.begin(), result.end(), [](const Bottleneck &a, const Bottleneck &b) {
+        return a.missing > b.missing;
+    });
+    return result;
+}
 
+BalanceReport Graph::balanceFlow() {
+    const ResidualGraph &r = getResidual();
+    BalanceReport report;
+    report.costBefore = r.utilizationCost(state);
+    report.augmentations = r.balance(state);
+    report.costAfter = r.utilizationCost(state);
+    r.store(state);
+    return report;
+}
+
+unsigned Graph::edmondsKarp() {
+    // to start from scratch, reset all flows before running
+    const ResidualGraph &r = getResidual();
+    unsigned iterations = r.edmondsKarp(state);
+    unsolved.assign(components.count(), false);
+    r.store(state);
+    return iterations;
+}
+
+Capacity Graph::fordFulkerson(unsigned *iterations) {
+    const ResidualGraph &r = getResidual();
+    Capacity totalFlow = r.fordFulkerson(state, iterations);
+    unsolved.assign(components.count(), false);
+    r.store(state);
     return totalFlow;
 }
 
-void Graph::recursiveAugmentingPath(Vertex *v, std::vector<Edge *> &toIncreaseFlow, std::vector<Edge *> &toDecreaseFlow,
-                                    double &flow, bool &found) {
-    v->setVisited(true);
-    for (Edge *e: v->getAdj()) {
-        Vertex *w = e->getDest();
-        if (!w->isVisited() && e->getFlow() < e->getWeight()) {
-            if (w == this->sink) { // If the vertex is the target
-                found = true;
-                flow = e->getWeight() - e->getFlow();
-                toIncreaseFlow.push_back(e);
-                return;
-            }
-            recursiveAugmentingPath(w, toIncreaseFlow, toDecreaseFlow, flow, found);
-            if (found) { // If the target was found ...
-                flow = std::min(flow, e->getWeight() - e->getFlow()); // ... the flow for that path must be updated
-                toIncreaseFlow.push_back(e);
-                return;
-            }
-        }
-    }
+unsigned Graph::dinic() {
+    const ResidualGraph &r = getResidual();
+    unsigned iterations = r.dinic(state);
+    unsolved.assign(components.count(), false);
+    r.store(state);
+    return iterations;
+}
 
-    for (Edge *e: v->getIncoming()) { // The same loop as before, but now, we consider back-edges.
-        Vertex *w = e->getOrig();
-        if (!w->isVisited() && e->getFlow() > 0) {
-            // Assuming that the vertex is not the target.
-            recursiveAugmentingPath(w, toIncreaseFlow, toDecreaseFlow, flow, found);
-            if (found) { // If the target was found ...
-                flow = std::min(flow, e->getFlow()); // ... the flow for that path must be updated
-                toDecreaseFlow.push_back(e);
-                return;
-            }
-        }
+unsigned Graph::pushRelabel() {
+    const ResidualGraph &r = getResidual();
+    unsigned iterations = r.pushRelabel(state);
+    unsolved.assign(components.count(), false);
+    r.store(state);
+    return iterations;
+}
+
+unsigned Graph::maxFlow() {
+    PhaseTimer timer("max_flow");
+    const ResidualGraph &r = getResidual();
+    unsigned iterations = components.solve(r, state, unsolved, algorithm, threads);
+    unsolved.assign(components.count(), false);
+    r.store(state);
+    return iterations;
+}
+
+const Components &Graph::getComponents() const {
+    getResidual();
+    return components;
+}
+
+max_flow_algorithm Graph::getAlgorithm() const {
+    return algorithm;
+}
+
+void Graph::setAlgorithm(max_flow_algorithm algorithm) {
+    this->algorithm = algorithm;
+}
+
+bool Graph::parseAlgorithm(const std::string &name, max_flow_algorithm &algorithm) {
+    if (name == "edmonds_karp") algorithm = EDMONDS_KARP;
+    else if (name == "ford_fulkerson") algorithm = FORD_FULKERSON;
+    else if (name == "dinic") algorithm = DINIC;
+    else if (name == "push_relabel") algorithm = PUSH_RELABEL;
+    else return false;
+    return true;
+}
+
+std::string Graph::algorithmName(max_flow_algorithm algorithm) {
+    switch (algorithm) {
+        case EDMONDS_KARP:   return "edmonds_karp";
+        case FORD_FULKERSON: return "ford_fulkerson";
+        case DINIC:          return "dinic";
+        case PUSH_RELABEL:   return "push_relabel";
     }
+    return "";
 }
 
 void Graph::reset() {
-    for (Vertex *v: this->vertexSet) {
-        v->setVisited(false);
-        v->setPath(nullptr);
-        for (Edge *e: v->getAdj())
-            e->setFlow(0);
-    }
-    for (Edge *e: this->source->getAdj())
-        e->setFlow(0);
+    resetFlow(); // the algorithms keep their search state in the FlowState, not in the vertexes
 }
 
 void Graph::resetFlow() {
+    unsolved.assign(unsolved.size(), true);
     for (Vertex *v: vertexSet)
         for (Edge *e: v->getAdj())
             e->setFlow(0);
@@ -432,6 +714,8 @@ void Graph::resetFlow() {
 }
 
 void Graph::restore() {
+    residualUpToDate = false;
+    checkpoints.clear();
     for (Vertex *v: removedVertexes)
         this->addVertex(v);
     for (Edge *e: removedEdges) {
@@ -451,22 +735,475 @@ const std::vector<Edge *> &Graph::getRemovedEdges() const {
     return removedEdges;
 }
 
+unsigned Graph::checkpoint() {
+    getResidual();
+    if (checkpoints.empty())
+        state.setJournaling(true);
+    checkpoints.push_back({state.journalSize(), removedVertexes.size(), removedEdges.size(), unsolved});
+    return checkpoints.size();
+}
+
+bool Graph::rollback(unsigned n) {
+    if (n == 0 || n > checkpoints.size())
+        return false;
+    Checkpoint target = checkpoints[checkpoints.size() - n];
+    checkpoints.resize(checkpoints.size() - n);
+
+    const ResidualGraph &r = getResidual();
+    r.rollback(state, target.journal);
+    for (size_t i = target.vertexes; i < removedVertexes.size(); i++)
+        insertVertex(removedVertexes[i]);
+    removedVertexes.resize(target.vertexes);
+    for (size_t i = target.edges; i < removedEdges.size(); i++) { // the edges of a removed vertex are relinked here too
+        Edge *e = removedEdges[i];
+        e->getOrig()->getAdj().push_back(e);
+        e->getDest()->getIncoming().push_back(e);
+        r.restoreArc(state, r.arcOf(e));
+    }
+    removedEdges.resize(target.edges);
+    unsolved = target.unsolved;
+    r.store(state);
+
+    if (checkpoints.empty())
+        state.setJournaling(false);
+    return true;
+}
+
+unsigned Graph::getCheckpoints() const {
+    return checkpoints.size();
+}
+
+unsigned Graph::getThreads() const {
+    return threads;
+}
+
+void Graph::setThreads(unsigned threads) {
+    this->threads = threads;
+}
+
+//! Time Complexity: O(V * E³ / threads), Space Complexity: O(threads * (V + E) + P * V)
 void Graph::calculateDependency() {
-    for (Vertex *a: this->vertexSet) {
-        if (a->getType() == CITY) continue;
-        for (Edge *to_remove: a->getAdj()) {
-            Graph copy = Graph(*this);
-            this->removeEdge(to_remove->getOrig(), to_remove->getDest());
-            this->edmondsKarp();
-            for (auto c: this->cityVertexes) {
-                double difference = copy.getCityVertexes().at(c.second->getTypeId())->getAdj()[0]->getFlow() -
-                                    c.second->getAdj()[0]->getFlow();
-                if (difference > 0) {
-                    c.second->addDependency(to_remove, difference);
-                }
+    std::vector<Vertex *> cities;
+    for (auto p: cityVertexes)
+        cities.push_back(p.second);
+    calculateDependency(cities);
+}
+
+//! Time Complexity: O(p * F / threads), Space Complexity: O(threads * (V + E) + P * V)
+void Graph::calculateDependency(const std::vector<Vertex *> &cities) {
+    PhaseTimer timer("dependency");
+    validateDependencyCache();
+    const PathIndex &index = getPathIndex(); // also brings the arrays up to date
+    const ResidualGraph &r = residual;
+    std::vector<bool> wanted(r.vertexCount(), false);
+    std::vector<unsigned> cityArcs; // arc to the sink of each city
+    for (Vertex *c: cities) {
+        c->clearDependency();
+        wanted[c->getIndex()] = true;
+        cityArcs.push_back(r.arcOf(c->getAdj()[0]));
+    }
+
+    // the pipes the water of the cities goes through; any other pipe carries none of it
+    std::vector<unsigned> pipes;
+    for (unsigned p: index.pathsThrough(cityArcs))
+        for (unsigned a: index.getArcs(p))
+            if (r.getEdge(a)->getOrig() != source && r.getEdge(a)->getDest() != sink)
+                pipes.push_back(a);
+    std::sort(pipes.begin(), pipes.end());
+    pipes.erase(std::unique(pipes.begin(), pipes.end()), pipes.end());
+
+    // every worker repairs the network on its own copy of the flow; the arrays are only read
+    const std::vector<Capacity> &saved = state.getFlows();
+    std::vector<FlowState> workers(workerCount(pipes.size(), threads), state);
+    std::vector<std::vector<FlowState>> scratch(workers.size(), components.newStates());
+    std::vector<std::vector<std::pair<Vertex *, Capacity>>> affected(pipes.size());
+    parallelFor(pipes.size(), threads, [&](unsigned worker, unsigned i) {
+        std::vector<unsigned> through; // arcs to the sink of the wanted cities whose water goes through the pipe
+        for (unsigned p: index.pathsThrough({pipes[i]}))
+            if (wanted[r.getTail(index.getCityArc(p))])
+                through.push_back(index.getCityArc(p));
+        std::sort(through.begin(), through.end());
+        through.erase(std::unique(through.begin(), through.end()), through.end());
+
+        FlowState &s = workers[worker];
+        r.cutArc(s, pipes[i]);
+        components.solve(r, s, components.componentOf(r.getTail(pipes[i])), algorithm, scratch[worker]);
+        for (unsigned a: through) {
+            Capacity difference = saved[a] - s.getFlow(a);
+            if (difference > 0)
+                affected[i].emplace_back(getVertex(r.getTail(a)), difference);
+        }
+        r.restoreArc(s, pipes[i]);
+        s.setFlows(saved);
+    });
+
+    // merging in the order of the pipes gives the same vectors as a serial run
+    for (unsigned i = 0; i < pipes.size(); i++)
+        for (const std::pair<Vertex *, Capacity> &c: affected[i])
+            c.first->addDependency(r.getEdge(pipes[i]), c.second);
+    for (Vertex *c: cities)
+        dependencyKnown[c->getIndex()] = true;
+}
+
+//! Time Complexity: O(E) if cached, O(p * F / threads) otherwise, Space Complexity: O(E)
+const std::vector<std::pair<Edge *, Capacity>> &Graph::getDependency(Vertex *city) {
+    if (!isDependencyKnown(city))
+        calculateDependency({city});
+    return city->getDependency();
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+bool Graph::isDependencyKnown(const Vertex *city) const {
+    return city->getIndex() < dependencyKnown.size() && dependencyKnown[city->getIndex()] && dependencyCacheValid();
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+void Graph::setDependencyKnown(const std::vector<Vertex *> &cities) {
+    dependencyFlows.clear(); // forces the key to be taken again
+    validateDependencyCache();
+    for (Vertex *c: cities)
+        dependencyKnown[c->getIndex()] = true;
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+bool Graph::dependencyCacheValid() const {
+    const ResidualGraph &r = getResidual();
+    if (state.getFlows() != dependencyFlows || state.getRemoved() != dependencyRemoved || dependencyCapacities.size() != r.arcCount())
+        return false;
+    for (unsigned a = 0; a < r.arcCount(); a++)
+        if (r.getCapacity(a) != dependencyCapacities[a])
+            return false;
+    return true;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(E)
+void Graph::validateDependencyCache() {
+    if (dependencyCacheValid())
+        return;
+    const ResidualGraph &r = getResidual();
+    dependencyKnown.assign(getIndexCount(), false);
+    dependencyFlows = state.getFlows();
+    dependencyRemoved = state.getRemoved();
+    dependencyCapacities.resize(r.arcCount());
+    for (unsigned a = 0; a < r.arcCount(); a++)
+        dependencyCapacities[a] = r.getCapacity(a);
+}
+
+FailureReport Graph::kFailures(unsigned k, unsigned top) const {
+    FailureReport report;
+    const ResidualGraph &r = getResidual();
+    const FlowState base = state;
+
+    std::vector<std::pair<Vertex *, unsigned>> cities; // each city and the arc to the sink
+    for (auto p: cityVertexes)
+        cities.emplace_back(p.second, r.arcOf(p.second->getAdj()[0]));
+    std::sort(cities.begin(), cities.end(), [](const std::pair<Vertex *, unsigned> &a, const std::pair<Vertex *, unsigned> &b) {
+        return a.first->getTypeId() < b.first->getTypeId();
+    });
+
+    std::vector<std::vector<unsigned>> arcs; // arcs cut by each failure point
+    std::vector<Vertex *> stations;
+    for (auto p: stationVertexes)
+        stations.push_back(p.second);
+    std::sort(stations.begin(), stations.end(), [](Vertex *a, Vertex *b) { return a->getTypeId() < b->getTypeId(); });
+    for (Vertex *v: stations) {
+        report.points.push_back({nullptr, v});
+        arcs.emplace_back();
+        for (Edge *e: v->getAdj())
+            arcs.back().push_back(r.arcOf(e));
+        for (Edge *e: v->getIncoming())
+            arcs.back().push_back(r.arcOf(e));
+    }
+    for (unsigned a = 0; a < r.arcCount(); a++) {
+        Edge *e = r.getEdge(a);
+        if (e == nullptr || e->getOrig() == source || e->getDest() == sink || base.isRemoved(a))
+            continue;
+        report.points.push_back({e, nullptr});
+        arcs.push_back({a});
+    }
+    const unsigned n = report.points.size();
+    if (k == 0 || k > n)
+        return report;
+
+    // a failure point whose arcs carry no flow can be cut without changing the maximum flow
+    auto carries = [&](const FlowState &s, unsigned point) {
+        for (unsigned a: arcs[point])
+            if (s.getFlow(a) > 0)
+                return true;
+        return false;
+    };
+    // worse first, then by members, so the rankings do not depend on the order the combinations are found
+    auto worse = [](const FailureScenario &a, const FailureScenario &b) {
+        if (a.deficit != b.deficit)
+            return a.deficit > b.deficit;
+        return a.members < b.members;
+    };
+
+    // combinatorial number system, to key the combinations of k - 1 points by their rank
+    std::vector<std::vector<unsigned long>> binomial(n + 1, std::vector<unsigned long>(k + 1, 0));
+    for (unsigned i = 0; i <= n; i++) {
+        binomial[i][0] = 1;
+        for (unsigned j = 1; j <= std::min(i, k); j++)
+            binomial[i][j] = binomial[i - 1][j - 1] + binomial[i - 1][j];
+    }
+    // rank of the members in the combinatorial number system, leaving out the one at index skip
+    auto rankWithout = [&](const std::vector<unsigned> &members, unsigned skip) {
+        unsigned long rank = 0;
+        for (unsigned i = 0, position = 1; i < members.size(); i++)
+            if (i != skip)
+                rank += binomial[members[i]][position++];
+        return rank;
+    };
+    const unsigned C = cities.size();
+    // water each combination of k - 1 points takes from the cities it affects, by city, keyed by its rank;
+    // the combinations that take no water are left out, so the table grows with the damage found, not with the combinations
+    typedef std::unordered_map<unsigned long, std::vector<std::pair<unsigned, Capacity>>> DamageTable;
+    DamageTable damage;
+
+    struct Worker {
+        std::vector<FlowState> stack;                               // flow with the first d members failed, for each depth d
+        std::vector<unsigned> members;
+        std::vector<std::vector<FailureScenario>> heaps;            // ranking of each city, as a heap with the mildest on top
+        DamageTable damage;                                         // filled by the first pass, merged into the shared table
+        std::vector<const std::vector<std::pair<unsigned, Capacity>> *> without; // damage of the members but the one at each index
+        unsigned long evaluated = 0, skipped = 0;
+    };
+    std::vector<Worker> workers(workerCount(n, threads));
+    for (Worker &w: workers) {
+        w.stack.assign(k + 1, base);
+        w.heaps.resize(C);
+        w.without.resize(k);
+    }
+
+    // a combination is only ranked for a city if every member adds to the damage of the other k - 1
+    auto damageOf = [](const std::vector<std::pair<unsigned, Capacity>> *cityDamage, unsigned c) {
+        if (cityDamage == nullptr)
+            return (Capacity) 0;
+        auto it = std::lower_bound(cityDamage->begin(), cityDamage->end(), c,
+                                   [](const std::pair<unsigned, Capacity> &d, unsigned city) { return d.first < city; });
+        return it != cityDamage->end() && it->first == c ? it->second : (Capacity) 0;
+    };
+    auto record = [&](Worker &w, const FlowState &s) {
+        for (unsigned x = 0; x < k && k > 1; x++) {
+            auto it = damage.find(rankWithout(w.members, x));
+            w.without[x] = it == damage.end() ? nullptr : &it->second;
+        }
+        for (unsigned c = 0; c < C; c++) {
+            Capacity deficit = base.getFlow(cities[c].second) - s.getFlow(cities[c].second);
+            bool needed = deficit > 0;
+            for (unsigned x = 0; x < k && needed && k > 1; x++)
+                needed = deficit > damageOf(w.without[x], c);
+            if (!needed)
+                continue;
+            std::vector<FailureScenario> &heap = w.heaps[c];
+            FailureScenario scenario{w.members, deficit};
+            if (heap.size() < top) {
+                heap.push_back(scenario);
+                std::push_heap(heap.begin(), heap.end(), worse);
+            } else if (top > 0 && worse(scenario, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), worse);
+                heap.back() = scenario;
+                std::push_heap(heap.begin(), heap.end(), worse);
+            }
+        }
+    };
+
+    // fails a point on top of the d points already failed in stack[d], then explores the combinations that extend it
+    // the first pass goes as deep as k - 1 and fills the damage table, the second one ranks the combinations of size k
+    unsigned depth;
+    std::function<void(Worker &, unsigned, unsigned)> extend = [&](Worker &w, unsigned d, unsigned point) {
+        bool flowing = carries(w.stack[d], point);
+        if (d + 1 == k && !flowing) { // it takes as much water as its first k - 1 members, so it is never ranked
+            ++w.skipped;
+            return;
+        }
+        FlowState &s = w.stack[d + 1];
+        s = w.stack[d];
+        for (unsigned a: arcs[point])
+            r.cutArc(s, a);
+        if (flowing)
+            r.maxFlow(s, algorithm);
+        w.members.push_back(point);
+        if (d + 1 == k) {
+            ++w.evaluated;
+            record(w, s);
+        } else if (d + 1 == depth) {
+            std::vector<std::pair<unsigned, Capacity>> cityDamage;
+            for (unsigned c = 0; c < C; c++)
+                if (base.getFlow(cities[c].second) != s.getFlow(cities[c].second))
+                    cityDamage.emplace_back(c, base.getFlow(cities[c].second) - s.getFlow(cities[c].second));
+            if (!cityDamage.empty())
+                w.damage[rankWithout(w.members, w.members.size())] = std::move(cityDamage);
+        }
+        if (d + 1 < depth)
+            for (unsigned next = point + 1; next + (depth - d - 2) < n; next++)
+                extend(w, d + 1, next);
+        w.members.pop_back();
+    };
+    for (depth = k > 1 ? k - 1 : k; depth <= k; depth++) {
+        parallelFor(n - depth + 1, threads, [&](unsigned worker, unsigned point) {
+            extend(workers[worker], 0, point);
+        });
+        for (Worker &w: workers) { // each combination was found by one worker
+            for (auto &entry: w.damage)
+                damage.insert(std::move(entry));
+            DamageTable().swap(w.damage);
+        }
+    }
+
+    for (unsigned c = 0; c < C; c++) {
+        std::vector<FailureScenario> &ranking = report.ranking[cities[c].first];
+        for (Worker &w: workers)
+            ranking.insert(ranking.end(), w.heaps[c].begin(), w.heaps[c].end());
+        std::sort(ranking.begin(), ranking.end(), worse);
+        if (ranking.size() > top)
+            ranking.resize(top);
+    }
+    for (Worker &w: workers) {
+        report.evaluated += w.evaluated;
+        report.skipped += w.skipped;
+    }
+    return report;
+}
+
+//! Time Complexity: O(n * (k + F)), Space Complexity: O(threads * (V + E) + n * (C + R))
+std::vector<RemovalReport> Graph::evaluateRemovals(const std::vector<std::vector<FailurePoint>> &scenarios) const {
+    PhaseTimer timer("removals");
+    const ResidualGraph &r = getResidual();
+    const FlowState base = state;
+
+    // each city and reservoir with the arc to the sink or from the source, by type ID
+    auto byTypeId = [&r](const std::unordered_map<unsigned int, Vertex *> &vertexes, bool city) {
+        std::vector<std::pair<Vertex *, unsigned>> sorted;
+        for (auto p: vertexes)
+            sorted.emplace_back(p.second, r.arcOf(city ? p.second->getAdj()[0] : p.second->getIncoming()[0]));
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<Vertex *, unsigned> &a, const std::pair<Vertex *, unsigned> &b) {
+            return a.first->getTypeId() < b.first->getTypeId();
+        });
+        return sorted;
+    };
+    const std::vector<std::pair<Vertex *, unsigned>> cities = byTypeId(cityVertexes, true);
+    const std::vector<std::pair<Vertex *, unsigned>> reservoirs = byTypeId(reservoirVertexes, false);
+
+    std::vector<RemovalReport> reports(scenarios.size());
+    std::vector<FlowState> workers(workerCount(scenarios.size(), threads), base);
+    std::vector<std::vector<FlowState>> scratch(workers.size(), components.newStates());
+    parallelFor(scenarios.size(), threads, [&](unsigned worker, unsigned i) {
+        FlowState &s = workers[worker];
+        s = base; // also brings back the arcs cut by the previous scenario
+        std::vector<Vertex *> removed;
+        std::vector<unsigned> arcs, touched;
+        for (const FailurePoint &point: scenarios[i]) {
+            if (point.pipe != nullptr) {
+                arcs.push_back(r.arcOf(point.pipe));
+                continue;
             }
-            this->restore();
-            this->edmondsKarp();
+            removed.push_back(point.station);
+            for (Edge *e: point.station->getAdj())
+                arcs.push_back(r.arcOf(e));
+            for (Edge *e: point.station->getIncoming())
+                arcs.push_back(r.arcOf(e));
+        }
+        for (unsigned a: arcs) {
+            if (s.isRemoved(a)) // a pipe of a location removed in the same scenario
+                continue;
+            r.cutArc(s, a);
+            for (unsigned v: {r.getTail(a), r.getHead(a)})
+                if (components.componentOf(v) != Components::NONE)
+                    touched.push_back(components.componentOf(v));
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (unsigned c: touched)
+            components.solve(r, s, c, algorithm, scratch[worker]);
+
+        RemovalReport &report = reports[i];
+        for (const std::pair<Vertex *, unsigned> &c: cities) {
+            if (std::find(removed.begin(), removed.end(), c.first) != removed.end())
+                continue;
+            report.flow += s.getFlow(c.second);
+            if (s.getFlow(c.second) != base.getFlow(c.second))
+                report.cities.emplace_back(c.first, s.getFlow(c.second));
+        }
+        for (const std::pair<Vertex *, unsigned> &p: reservoirs)
+            if (s.getFlow(p.second) != base.getFlow(p.second) && std::find(removed.begin(), removed.end(), p.first) == removed.end())
+                report.reservoirs.emplace_back(p.first, s.getFlow(p.second));
+    });
+    return reports;
+}
+
+ReliabilityReport Graph::simulateFailures(unsigned samples, double probability, double percentile, unsigned long seed) const {
+    ReliabilityReport report;
+    const ResidualGraph &r = getResidual();
+    const FlowState base = state;
+
+    std::vector<std::pair<Vertex *, unsigned>> cities; // each city and the arc to the sink
+    for (auto p: cityVertexes)
+        cities.emplace_back(p.second, r.arcOf(p.second->getAdj()[0]));
+    std::vector<unsigned> pipes;
+    for (unsigned a = 0; a < r.arcCount(); a++) {
+        Edge *e = r.getEdge(a);
+        if (e != nullptr && e->getOrig() != source && e->getDest() != sink && !base.isRemoved(a))
+            pipes.push_back(a);
+    }
+    if (samples == 0)
+        return report;
+
+    const unsigned C = cities.size();
+    std::vector<double> deficits(samples * (C + 1)); // a row per sample, the last column is the whole network
+    std::vector<unsigned> failed(samples, 0);
+    std::vector<FlowState> workers(workerCount(samples, threads), base);
+    parallelFor(samples, threads, [&](unsigned worker, unsigned sample) {
+        // each sample takes its own run of the splitmix64 sequence of the seed, one number per pipe, so no two samples share one;
+        // the standard distributions are implementation-defined, so its 53 high bits are compared to the probability directly
+        uint64_t rng = seed + 0x9E3779B97F4A7C15ULL * (sample + 1) * (uint64_t) pipes.size();
+        auto fails = [&rng, probability]() {
+            uint64_t z = (rng += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z ^= z >> 31;
+            return (double) (z >> 11) / 9007199254740992.0 < probability; // 2^53
+        };
+
+        FlowState &s = workers[worker];
+        s = base; // the cut flags of the previous sample go away too
+        bool repair = false;
+        for (unsigned a: pipes) {
+            if (!fails()) continue;
+            ++failed[sample];
+            repair |= s.getFlow(a) > 0;
+            r.cutArc(s, a);
+        }
+        if (repair) // failures of pipes without flow cannot reduce the maximum flow
+            r.maxFlow(s, algorithm);
+
+        double *row = &deficits[sample * (C + 1)];
+        for (unsigned c = 0; c < C; c++) {
+            row[c] = (double) (base.getFlow(cities[c].second) - s.getFlow(cities[c].second));
+            row[C] += row[c];
+        }
+    });
+
+    // nearest-rank percentile
+    unsigned rank = std::min(samples - 1, (unsigned) std::max(0.0, std::ceil(percentile * samples) - 1));
+    std::vector<double> column(samples);
+    for (unsigned c = 0; c <= C; c++) {
+        double sum = 0;
+        for (unsigned i = 0; i < samples; i++) {
+            column[i] = deficits[i * (C + 1) + c];
+            sum += column[i];
+        }
+        std::nth_element(column.begin(), column.begin() + rank, column.end());
+        if (c < C) {
+            report.expected[cities[c].first] = sum / samples;
+            report.percentile[cities[c].first] = column[rank];
+        } else {
+            report.expectedTotal = sum / samples;
+            report.percentileTotal = column[rank];
         }
     }
+    for (unsigned f: failed)
+        report.failedPipes += f;
+    report.failedPipes /= samples;
+    return report;
 }
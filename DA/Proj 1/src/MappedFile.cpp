@@ -0,0 +1,61 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Definition of class MappedFile
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/MappedFile.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+MappedFile::MappedFile(const std::string &file) {
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        length = info.st_size;
+        if (length == 0) {
+            open = true; // mmap does not take empty mappings
+        } else {
+            void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = (const char *) mapping;
+                open = true;
+            } else {
+                length = 0;
+            }
+        }
+    }
+    close(fd);
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+MappedFile::~MappedFile() {
+    if (data != nullptr)
+        munmap((void *) data, length);
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+bool MappedFile::isOpen() const {
+    return open;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+const char *MappedFile::begin() const {
+    return data;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+const char *MappedFile::end() const {
+    return data + length;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+size_t MappedFile::size() const {
+    return length;
+}
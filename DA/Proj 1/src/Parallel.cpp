@@ -0,0 +1,41 @@
+/**
+ * @file Parallel.cpp
+ * @brief Definition of the helpers that spread independent tasks over threads
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned workerCount(unsigned tasks, unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    return std::max(1u, std::min(tasks, threads));
+}
+
+//! Time Complexity: O(tasks) calls of job, Space Complexity: O(threads)
+void parallelFor(unsigned tasks, unsigned threads, const std::function<void(unsigned, unsigned)> &job) {
+    unsigned workers = workerCount(tasks, threads);
+    if (workers == 1) {
+        for (unsigned task = 0; task < tasks; task++)
+            job(0, task);
+        return;
+    }
+
+    std::atomic<unsigned> next(0);
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (unsigned worker = 0; worker < workers; worker++) {
+        pool.emplace_back([&, worker]() {
+            for (unsigned task = next++; task < tasks; task = next++)
+                job(worker, task);
+        });
+    }
+    for (std::thread &t: pool)
+        t.join();
+}
@@ -6,15 +6,348 @@
 */
 
 #include "../lib/Parser.hpp"
+#include "../lib/Parallel.hpp"
+#include "../lib/Stats.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+// The files are memory-mapped and split in place: a Field is a range of the mapping, never copied nor null-terminated.
+// Reading (tokenizing and converting numbers) touches no Graph, so the four files can be read concurrently; building
+// then adds the records to the Graph in the original order, so the vertexes and edges are the same as before.
+
+//! Range of characters of a mapped file
+struct Field {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+};
+
+//! Line of Cities.csv: City,Id,Code,Demand,Population
+struct CityRecord {
+    Field name;
+    unsigned id, demand, population;
+};
+
+//! Line of Reservoirs.csv: Reservoir,Municipality,Id,Code,Maximum Delivery
+struct ReservoirRecord {
+    Field name, municipality;
+    unsigned id;
+    double max;
+};
+
+//! Line of Stations.csv: Id,Code
+struct StationRecord {
+    unsigned id;
+};
+
+//! Line of Pipes.csv: Service_Point_A,Service_Point_B,Capacity,Direction, with both codes already resolved to (type, id)
+struct PipeRecord {
+    node_type typeA, typeB;
+    unsigned idA, idB;
+    double capacity;
+    bool bidirectional;
+};
+
+//! Records of a file, with the messages of the lines that could not be read
+template<typename Record>
+struct Table {
+    std::vector<Record> records;
+    std::vector<std::string> errors;     /*!< Printed when the table is built, so threads never write to std::cerr */
+};
 
 //! Time Complexity: O(1), Space Complexity: O(1)
-bool check_file(const std::string filename, std::fstream &In) {
-    if (filename.substr(filename.length() - 4, 4) == ".csv" && In.good())
+bool check_file(const std::string filename, const MappedFile &In) {
+    if (filename.length() >= 4 && filename.compare(filename.length() - 4, 4, ".csv") == 0 && In.isOpen())
         return true;
     std::cerr << "The filename " << filename << " is invalid\n";
     return false;
 }
 
+//! Splits a mapped file into lines and fields, skipping the header line (and with it the UTF-8 BOM) and empty lines
+class CsvReader {
+private:
+    const char *pos, *limit;
+
+public:
+    //! Time Complexity: O(h), h - length of the header line, Space Complexity: O(1)
+    explicit CsvReader(const MappedFile &file) : pos(file.begin()), limit(file.end()) {
+        Field header[1];
+        next(header, 1);
+    }
+
+    //! Reads the next line into at most n fields, the last one taking the rest of the line
+    //! Returns the number of fields, 0 when the file is over
+    //! Time Complexity: O(l), l - length of the line, Space Complexity: O(1)
+    unsigned next(Field *fields, unsigned n) {
+        while (pos < limit) {
+            const char *newline = (const char *) std::memchr(pos, '\n', limit - pos);
+            const char *end = newline == nullptr ? limit : newline, *start = pos;
+            pos = newline == nullptr ? limit : newline + 1;
+            if (end > start && end[-1] == '\r')
+                end--;
+            if (start == end)
+                continue;
+            unsigned count = 0;
+            while (count + 1 < n) {
+                const char *comma = (const char *) std::memchr(start, ',', end - start);
+                if (comma == nullptr)
+                    break;
+                fields[count].begin = start;
+                fields[count++].end = comma;
+                start = comma + 1;
+            }
+            fields[count].begin = start;
+            fields[count++].end = end;
+            return count;
+        }
+        return 0;
+    }
+};
+
+//! Reads the leading digits of a field, ignoring any decimal part ("52.00" is 52)
+//! Time Complexity: O(l), l - length of the field, Space Complexity: O(1)
+static bool toUnsigned(const Field &f, unsigned &out) {
+    const char *c = f.begin;
+    while (c < f.end && *c == ' ')
+        c++;
+    unsigned long long value = 0;
+    const char *digits = c;
+    for (; c < f.end && *c >= '0' && *c <= '9'; c++) {
+        value = value * 10 + (*c - '0');
+        if (value > UINT_MAX)
+            return false;
+    }
+    out = (unsigned) value;
+    return c != digits && (c == f.end || *c == '.');
+}
+
+//! Reads a decimal number, exactly when it fits in a double mantissa and has at most 22 decimals, with strtod otherwise
+//! Time Complexity: O(l), l - length of the field, Space Complexity: O(1)
+static bool toDouble(const Field &f, double &out) {
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+                                    1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    unsigned long long mantissa = 0;
+    int decimals = -1, digits = 0;
+    const char *c = f.begin;
+    for (; c < f.end; c++) {
+        if (*c >= '0' && *c <= '9') {
+            mantissa = mantissa * 10 + (*c - '0');
+            if (decimals >= 0)
+                decimals++;
+            if (++digits > 15)
+                break;
+        } else if (*c == '.' && decimals < 0) {
+            decimals = 0;
+        } else {
+            break;
+        }
+    }
+    if (c == f.end && digits > 0) {   // Both operands are exact, so the division is correctly rounded
+        out = (double) mantissa / powers[decimals < 0 ? 0 : decimals];
+        return true;
+    }
+    char buffer[64];
+    size_t length = f.end - f.begin;
+    if (length == 0 || length >= sizeof(buffer))
+        return false;
+    std::memcpy(buffer, f.begin, length);
+    buffer[length] = '\0';
+    char *end;
+    out = std::strtod(buffer, &end);
+    return end == buffer + length;
+}
+
+//! Converts a number read from a file to the capacity type, rounding it to the nearest integer if Capacity is integral
+//! Time Complexity: O(1), Space Complexity: O(1)
+static Capacity toCapacity(double value) {
+    return std::is_integral<Capacity>::value ? (Capacity) std::llround(value) : (Capacity) value;
+}
+
+//! Resolves C_<id>, R_<id> and PS_<id> without building any string
+//! Time Complexity: O(l), l - length of the field, Space Complexity: O(1)
+static bool toCode(const Field &f, node_type &type, unsigned &id) {
+    Field number = f;
+    size_t length = f.end - f.begin;
+    if (length > 2 && f.begin[0] == 'C' && f.begin[1] == '_') {
+        type = CITY;
+        number.begin += 2;
+    } else if (length > 2 && f.begin[0] == 'R' && f.begin[1] == '_') {
+        type = RESERVOIR;
+        number.begin += 2;
+    } else if (length > 3 && f.begin[0] == 'P' && f.begin[1] == 'S' && f.begin[2] == '_') {
+        type = STATION;
+        number.begin += 3;
+    } else {
+        return false;
+    }
+    return toUnsigned(number, id) && std::memchr(number.begin, '.', number.end - number.begin) == nullptr;
+}
+
+//! Time Complexity: O(l), l - length of the field, Space Complexity: O(l)
+static std::string toString(const Field &f) {
+    return std::string(f.begin, f.end - f.begin);
+}
+
+//! Time Complexity: O(n), n - size of the file, Space Complexity: O(1)
+static size_t countLines(const MappedFile &file) {
+    size_t lines = 0;
+    for (const char *c = file.begin(); c != file.end(); c++)
+        lines += *c == '\n';
+    return lines + 1;
+}
+
+//! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
+static void readCities(const MappedFile &file, Table<CityRecord> &table) {
+    CsvReader reader(file);
+    table.records.reserve(countLines(file));
+    Field f[5];
+    unsigned count;
+    while ((count = reader.next(f, 5)) != 0) {
+        CityRecord r;
+        r.name = f[0];
+        if (count == 5 && toUnsigned(f[1], r.id) && toUnsigned(f[3], r.demand) && toUnsigned(f[4], r.population))
+            table.records.push_back(r);
+        else
+            table.errors.push_back("The city " + toString(f[0]) + " is invalid");
+    }
+}
+
+//! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
+static void readReservoirs(const MappedFile &file, Table<ReservoirRecord> &table) {
+    CsvReader reader(file);
+    table.records.reserve(countLines(file));
+    Field f[5];
+    unsigned count;
+    while ((count = reader.next(f, 5)) != 0) {
+        ReservoirRecord r;
+        r.name = f[0];
+        r.municipality = f[1];
+        if (count == 5 && toUnsigned(f[2], r.id) && toDouble(f[4], r.max))
+            table.records.push_back(r);
+        else
+            table.errors.push_back("The reservoir " + toString(f[0]) + " is invalid");
+    }
+}
+
+//! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
+static void readStations(const MappedFile &file, Table<StationRecord> &table) {
+    CsvReader reader(file);
+    table.records.reserve(countLines(file));
+    Field f[2];
+    while (reader.next(f, 2) != 0) {
+        StationRecord r;
+        if (toUnsigned(f[0], r.id))
+            table.records.push_back(r);
+        else
+            table.errors.push_back("The station " + toString(f[0]) + " is invalid");
+    }
+}
+
+//! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
+static void readPipes(const MappedFile &file, Table<PipeRecord> &table) {
+    CsvReader reader(file);
+    table.records.reserve(countLines(file));
+    Field f[4];
+    unsigned count;
+    while ((count = reader.next(f, 4)) != 0) {
+        PipeRecord r;
+        if (count != 4 || !toDouble(f[2], r.capacity)) {
+            table.errors.push_back("The pipe " + toString(f[0]) + " is invalid");
+            continue;
+        }
+        if (!toCode(f[0], r.typeA, r.idA)) {
+            table.errors.push_back("The code " + toString(f[0]) + " is invalid");
+            continue;
+        }
+        if (!toCode(f[1], r.typeB, r.idB)) {
+            table.errors.push_back("The code " + toString(f[1]) + " is invalid");
+            continue;
+        }
+        r.bidirectional = f[3].begin != f[3].end && f[3].begin[0] == '0';
+        table.records.push_back(r);
+    }
+}
+
+//! Time Complexity: O(e), Space Complexity: O(1), e - number of errors
+template<typename Record>
+static void printErrors(const Table<Record> &table) {
+    for (const std::string &error: table.errors)
+        std::cerr << error << std::endl;
+}
+
+//! Time Complexity: O(n), Space Complexity: O(1), n - number of records
+static void buildCities(Graph &network, const Table<CityRecord> &table) {
+    printErrors(table);
+    for (const CityRecord &r: table.records) {
+        Vertex *v = network.createVertex(CITY, r.id * 10 + 1, "", "", toString(r.name), r.population);
+        network.addEdge(v, network.getSink(), r.demand);
+        network.addVertex(v);
+    }
+}
+
+//! Time Complexity: O(n), Space Complexity: O(1), n - number of records
+static void buildReservoirs(Graph &network, const Table<ReservoirRecord> &table) {
+    printErrors(table);
+    for (const ReservoirRecord &r: table.records) {
+        // The last number of the ID yields the type
+        Vertex *v = network.createVertex(RESERVOIR, r.id * 10 + 2, toString(r.name), toString(r.municipality));
+        network.addVertex(v);
+        network.addEdge(network.getSource(), v, toCapacity(r.max));
+    }
+}
+
+//! Time Complexity: O(n), Space Complexity: O(1), n - number of records
+static void buildStations(Graph &network, const Table<StationRecord> &table) {
+    printErrors(table);
+    for (const StationRecord &r: table.records)
+        network.addVertex(network.createVertex(STATION, r.id * 10 + 3)); // The last number of the ID yields the type
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+static Vertex *computeVertex(const Graph &network, node_type type, unsigned id) {  // Depending on the code, the selected Vertex is different
+    Vertex *v = network.findVertex(type, id);
+    if (v == nullptr)
+        std::cerr << "The code " << (type == CITY ? "C_" : type == RESERVOIR ? "R_" : "PS_") << id << " is invalid"
+                  << std::endl;
+    return v;
+}
+
+//! Time Complexity: O(n log n), Space Complexity: O(n), n - number of records
+static void buildPipes(Graph &network, const Table<PipeRecord> &table) {
+    printErrors(table);
+    struct Pipe {
+        Vertex *orig, *dest;
+        Capacity capacity;
+    };
+    std::vector<Pipe> pipes;
+    pipes.reserve(2 * table.records.size());
+    for (const PipeRecord &r: table.records) {
+        Vertex *src = computeVertex(network, r.typeA, r.idA), *destination = computeVertex(network, r.typeB, r.idB);
+        if (src == nullptr || destination == nullptr)
+            continue;
+        pipes.push_back({src, destination, toCapacity(r.capacity)});
+        if (r.bidirectional)                      // Bidirectional
+            pipes.push_back({destination, src, toCapacity(r.capacity)});
+    }
+
+    // The edges are created grouped by origin, so the pipes of a vertex are contiguous in the arena,
+    // and then linked in the order of the file, which is the order of every adjacency and incoming vector
+    std::vector<unsigned> order(pipes.size());
+    for (unsigned i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&pipes](unsigned a, unsigned b) {
+        return pipes[a].orig->getIndex() < pipes[b].orig->getIndex();
+    });
+    std::vector<Edge *> edges(pipes.size());
+    for (unsigned i: order)
+        edges[i] = network.createEdge(pipes[i].orig, pipes[i].dest, pipes[i].capacity);
+    for (Edge *e: edges)
+        network.addEdge(e);
+}
+
 //! Time Complexity: O(t), Space Complexity: O(t), t - total number of lines
 Graph parse(
         const std::string cities_csv,
@@ -22,115 +355,84 @@ Graph parse(
         const std::string reservoirs_csv,
         const std::string stations_csv) {
     Graph network;
+    parse(network, cities_csv, pipes_csv, reservoirs_csv, stations_csv);
+    return network;
+}
 
-    parseCities(network, cities_csv);
+//! Time Complexity: O(t), Space Complexity: O(t), t - total number of lines
+void parse(
+        Graph &network,
+        const std::string cities_csv,
+        const std::string pipes_csv,
+        const std::string reservoirs_csv,
+        const std::string stations_csv) {
+    PhaseTimer timer("parse");
+    MappedFile cityFile(cities_csv), reservoirFile(reservoirs_csv), stationFile(stations_csv), pipeFile(pipes_csv);
+    bool valid[4] = {check_file(cities_csv, cityFile), check_file(reservoirs_csv, reservoirFile),
+                     check_file(stations_csv, stationFile), check_file(pipes_csv, pipeFile)};
+    Table<CityRecord> cities;
+    Table<ReservoirRecord> reservoirs;
+    Table<StationRecord> stations;
+    Table<PipeRecord> pipes;
+
+    parallelFor(4, network.getThreads(), [&](unsigned, unsigned task) {
+        if (!valid[task])
+            return;
+        switch (task) {
+            case 0: readCities(cityFile, cities); break;
+            case 1: readReservoirs(reservoirFile, reservoirs); break;
+            case 2: readStations(stationFile, stations); break;
+            default: readPipes(pipeFile, pipes);
+        }
+    });
+
+    buildCities(network, cities);
     std::cout << WHITE << std::setw(17) << "Parse Cities " << std::setw(18) << cities_csv << GREEN << " OK" << '\n';
 
-    parseReservoirs(network, reservoirs_csv);
+    buildReservoirs(network, reservoirs);
     std::cout << WHITE << std::setw(17) << "Parse Reservoirs " << std::setw(18) << reservoirs_csv << GREEN << " OK"
               << '\n';
 
-    parseStations(network, stations_csv);
+    buildStations(network, stations);
     std::cout << WHITE << std::setw(17) << "Parse Stations " << std::setw(18) << stations_csv << GREEN << " OK" << '\n';
 
-    parsePipes(network, pipes_csv);
+    buildPipes(network, pipes);
     std::cout << WHITE << std::setw(17) << "Parse Pipes " << std::setw(18) << pipes_csv << GREEN << " OK" << WHITE
               << '\n';
-
-    return network;
 }
 
 //! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
 void parseCities(Graph &network, const std::string file) {
-    std::fstream fs(file);
-    if (check_file(file, fs)) {
-        std::string city, id, demand, population;
-        getline(fs, city);
-        while (getline(fs, city, ',')) {
-            getline(fs, id, ',');
-            getline(fs, demand, ',');
-            getline(fs, demand, ',');
-            getline(fs, population);
-            unsigned int d = std::stoul(demand);
-            Vertex *v = new Vertex(
-                    CITY,
-                    (unsigned int) (std::stoul(id) * 10 + 1),
-                    "",
-                    "",
-                    city,
-                    (unsigned int) std::stoul(population));
-            v->addEdge(network.getSink(), d);
-            network.addVertex(v);
-        }
-    }
-}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-Vertex *computeVertex(Graph &network, std::string s) {  // Depending on the code, the selected Vertex is different
-    Vertex *v = nullptr;
-    switch (s[0]) {
-        case 'C':
-            v = network.getCityVertexes().at((unsigned int) std::stoul(s.substr(2, s.length() - 2)));
-            break;
-        case 'R':
-            v = network.getReservoirVertexes().at((unsigned int) std::stoul(s.substr(2, s.length() - 2)));
-            break;
-        case 'P':
-            v = network.getStationVertexes().at((unsigned int) (std::stoul(s.substr(3, s.length() - 3))));
-            break;
-        default:
-            std::cerr << "The code " << s << " is invalid" << std::endl;
-    }
-    return v;
+    MappedFile mapping(file);
+    Table<CityRecord> table;
+    if (check_file(file, mapping))
+        readCities(mapping, table);
+    buildCities(network, table);
 }
 
 //! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
 void parsePipes(Graph &network, const std::string file) {
-    std::fstream fs(file);
-    if (check_file(file, fs)) {                           // The file exists and is a comma-separated one
-        std::string source, dest, capacity, direction;    // The code isn't necessary
-        getline(fs, source);                              // The header line will be ignored
-        while (getline(fs, source, ',')) {                // While the file isn't over
-            getline(fs, dest, ',');
-            getline(fs, capacity, ',');                   // Code skipped
-            getline(fs, direction);
-            Vertex *src = computeVertex(network, source), *destination = computeVertex(network, dest);
-            double weight = std::stod(capacity);
-            src->addEdge(destination, weight);
-            if (direction[0] == '0')                      // Bidirectional
-                destination->addEdge(src, weight);
-        }
-    }
+    MappedFile mapping(file);
+    Table<PipeRecord> table;
+    if (check_file(file, mapping))
+        readPipes(mapping, table);
+    buildPipes(network, table);
 }
 
 //! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
 void parseReservoirs(Graph &network, const std::string file) {
-    std::fstream fs(file);
-    if (check_file(file, fs)) {          // The file exists and is a comma-separated one
-        std::string r, m, id, max;       // The code isn't necessary
-        getline(fs, r);                  // The header line will be ignored
-        while (getline(fs, r, ',')) {    // While the file isn't over
-            getline(fs, m, ',');
-            getline(fs, id, ',');
-            getline(fs, max, ',');       // Code skipped
-            getline(fs, max);
-            Vertex *v = new Vertex(RESERVOIR, (unsigned int) std::stoul(id) * 10 + 2, r, m);
-            // The last number of the ID yields the type
-            network.addVertex(v);
-            network.getSource()->addEdge(v, std::stod(max));
-        }
-    }
+    MappedFile mapping(file);
+    Table<ReservoirRecord> table;
+    if (check_file(file, mapping))
+        readReservoirs(mapping, table);
+    buildReservoirs(network, table);
 }
 
 //! Time Complexity: O(n), Space Complexity: O(n), n - number of lines
 void parseStations(Graph &network, const std::string file) {
-    std::fstream fs(file);
-    if (check_file(file, fs)) {            // The file exists and is a comma-separated one
-        std::string id, code;              // The code isn't necessary
-        getline(fs, id);                   // The header line will be ignored
-        while (getline(fs, id, ',')) {     // While the file isn't over
-            getline(fs, code);
-            network.addVertex(new Vertex(STATION, (unsigned int) std::stoul(id) * 10 + 3)); // The last number of the ID yields the type
-        }
-    }
+    MappedFile mapping(file);
+    Table<StationRecord> table;
+    if (check_file(file, mapping))
+        readStations(mapping, table);
+    buildStations(network, table);
 }
@@ -0,0 +1,151 @@
+/**
+ * @file PathIndex.cpp
+ * @brief Definition of class PathIndex
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/PathIndex.hpp"
+#include <algorithm>
+
+//! Time Complexity: O(P * V + E), Space Complexity: O(P * V + E)
+void PathIndex::build(const ResidualGraph &r, const ResidualGraph::FlowState &s) {
+    const unsigned n = r.vertexCount(), m = r.arcCount();
+    pathFirst.assign(1, 0);
+    pathArcs.clear();
+    amount.clear();
+    decomposed = s.getFlows();
+    cycles = 0;
+
+    // forward arcs that carry flow, grouped by their tail
+    std::vector<unsigned> outFirst(n + 1, 0), out;
+    std::vector<Capacity> remaining(m, 0);
+    for (unsigned a = 0; a < m; a++) {
+        if (r.getEdge(a) != nullptr && s.getFlow(a) > 0) {
+            remaining[a] = s.getFlow(a);
+            outFirst[r.getTail(a) + 1]++;
+        }
+    }
+    for (unsigned v = 0; v < n; v++)
+        outFirst[v + 1] += outFirst[v];
+    out.resize(outFirst[n]);
+    std::vector<unsigned> current(outFirst.begin(), outFirst.end() - 1);
+    for (unsigned a = 0; a < m; a++)
+        if (remaining[a] > 0)
+            out[current[r.getTail(a)]++] = a;
+    current.assign(outFirst.begin(), outFirst.end() - 1); // arcs before current[v] carry no more flow
+
+    std::vector<unsigned> path;
+    std::vector<unsigned> position(n, ~0u); // position of each vertex of the walk in it, ~0u if not on it
+    auto bottleneck = [&](size_t from, unsigned extra) {
+        Capacity b = remaining[extra];
+        for (size_t i = from; i < path.size(); i++)
+            b = std::min(b, remaining[path[i]]);
+        return b;
+    };
+    auto unwind = [&](size_t to) { // takes the vertexes after the to-th arc off the walk
+        while (path.size() > to) {
+            position[r.getHead(path.back())] = ~0u;
+            path.pop_back();
+        }
+    };
+
+    const unsigned source = ResidualGraph::SOURCE_INDEX, sink = ResidualGraph::SINK_INDEX;
+    position[source] = 0;
+    while (true) {
+        unsigned v = path.empty() ? source : r.getHead(path.back());
+        if (v == sink) {
+            Capacity b = bottleneck(0, path.back());
+            for (unsigned a: path) {
+                remaining[a] -= b;
+                pathArcs.push_back(a);
+            }
+            amount.push_back(b);
+            pathFirst.push_back(pathArcs.size());
+            unwind(0);
+            continue;
+        }
+        while (current[v] < outFirst[v + 1] && !(remaining[out[current[v]]] > 0))
+            current[v]++;
+        if (current[v] == outFirst[v + 1]) {
+            if (v == source)
+                break; // every path has been taken
+            // the flow is not conserved at v, so the walk is dropped and its arcs lose what cannot leave v
+            Capacity b = bottleneck(0, path.back());
+            for (unsigned a: path)
+                remaining[a] -= b;
+            unwind(0);
+            continue;
+        }
+        unsigned a = out[current[v]], w = r.getHead(a);
+        if (position[w] != ~0u) { // closed a cycle: it delivers no water, so its flow is cancelled
+            size_t start = position[w];
+            Capacity b = bottleneck(start, a);
+            remaining[a] -= b;
+            for (size_t i = start; i < path.size(); i++)
+                remaining[path[i]] -= b;
+            unwind(start);
+            cycles++;
+            continue;
+        }
+        position[w] = path.size() + 1;
+        path.push_back(a);
+    }
+
+    arcFirst.assign(m + 1, 0);
+    for (unsigned a: pathArcs)
+        arcFirst[a + 1]++;
+    for (unsigned a = 0; a < m; a++)
+        arcFirst[a + 1] += arcFirst[a];
+    arcPaths.resize(pathArcs.size());
+    current.assign(arcFirst.begin(), arcFirst.end() - 1);
+    for (unsigned p = 0; p + 1 < pathFirst.size(); p++) // in increasing order of path, so each list is sorted
+        for (unsigned i = pathFirst[p]; i < pathFirst[p + 1]; i++)
+            arcPaths[current[pathArcs[i]]++] = p;
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+bool PathIndex::matches(const ResidualGraph::FlowState &s) const {
+    return s.getFlows() == decomposed;
+}
+
+//! Time Complexity: O(k * log k), Space Complexity: O(k)
+std::vector<unsigned> PathIndex::pathsThrough(const std::vector<unsigned> &arcs) const {
+    std::vector<unsigned> paths;
+    for (unsigned a: arcs)
+        if (a + 1 < arcFirst.size())
+            paths.insert(paths.end(), arcPaths.begin() + arcFirst[a], arcPaths.begin() + arcFirst[a + 1]);
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return paths;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned PathIndex::pathCount() const {
+    return amount.size();
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+Capacity PathIndex::getAmount(unsigned p) const {
+    return amount[p];
+}
+
+//! Time Complexity: O(l), Space Complexity: O(l)
+std::vector<unsigned> PathIndex::getArcs(unsigned p) const {
+    return std::vector<unsigned>(pathArcs.begin() + pathFirst[p], pathArcs.begin() + pathFirst[p + 1]);
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned PathIndex::getCityArc(unsigned p) const {
+    return pathArcs[pathFirst[p + 1] - 1];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned PathIndex::getReservoirArc(unsigned p) const {
+    return pathArcs[pathFirst[p]];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned PathIndex::getCycles() const {
+    return cycles;
+}
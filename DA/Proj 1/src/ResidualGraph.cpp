@@ -0,0 +1,830 @@
+/**
+ * @file ResidualGraph.cpp
+ * @brief Definition of class ResidualGraph
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/ResidualGraph.hpp"
+#include "../lib/Graph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+template<typename Cap>
+void BasicResidualGraph<Cap>::build(const Graph &g) {
+    Stats::add(STAT_ALLOCATIONS, 1);
+    unsigned n = g.getIndexCount(); // the Source and the Sink have indexes 0 and 1
+    first.assign(n + 1, 0);
+    for (unsigned i = 0; i < n; i++)
+        first[i + 1] = first[i] + g.getVertex(i)->getAdj().size() + g.getVertex(i)->getIncoming().size();
+
+    unsigned arcs = first.back();
+    head.resize(arcs);
+    reverse.resize(arcs);
+    capacity.resize(arcs);
+    edges.resize(arcs);
+
+    // the forward arcs come first, so the reverse arcs can find their pair by edge
+    this->arcs.assign(g.getEdgeIndexCount(), 0);
+    for (unsigned i = 0; i < n; i++) {
+        unsigned a = first[i];
+        for (Edge *e: g.getVertex(i)->getAdj()) {
+            head[a] = e->getDest()->getIndex();
+            capacity[a] = static_cast<Cap>(e->getWeight());
+            edges[a] = e;
+            this->arcs[e->getIndex()] = a++;
+        }
+    }
+    for (unsigned i = 0; i < n; i++) {
+        const Vertex *v = g.getVertex(i);
+        unsigned a = first[i] + v->getAdj().size();
+        for (Edge *e: v->getIncoming()) {
+            unsigned f = this->arcs[e->getIndex()];
+            head[a] = e->getOrig()->getIndex();
+            capacity[a] = 0;
+            edges[a] = nullptr;
+            reverse[a] = f;
+            reverse[f] = a++;
+        }
+    }
+}
+
+//! Time Complexity: O(V' + E'), Space Complexity: O(V' + E')
+template<typename Cap>
+void BasicResidualGraph<Cap>::build(const BasicResidualGraph &whole, const std::vector<unsigned> &vertexes,
+                                    std::vector<unsigned> &local, std::vector<unsigned> &arcMap) {
+    Stats::add(STAT_ALLOCATIONS, 1);
+    const unsigned n = vertexes.size() + 2;
+    for (unsigned i = 0; i < vertexes.size(); i++)
+        local[vertexes[i]] = i + 2;
+    // local may still hold the indexes of other parts, so membership is checked both ways
+    auto inPart = [&](unsigned v) {
+        return v != SOURCE_INDEX && v != SINK_INDEX && local[v] >= 2 && local[v] < n && vertexes[local[v] - 2] == v;
+    };
+
+    // the source and the sink only keep their arcs into the part, the other vertexes keep all of theirs
+    std::unordered_map<unsigned, unsigned> terminal; // arc of the part of each arc of the source and the sink
+    first.assign(n + 1, 0);
+    arcMap.clear();
+    for (unsigned v = 0; v < n; v++) {
+        unsigned w = v < 2 ? v : vertexes[v - 2];
+        for (unsigned a = whole.first[w]; a < whole.first[w + 1]; a++) {
+            if (v < 2) {
+                if (!inPart(whole.head[a])) continue;
+                terminal[a] = arcMap.size();
+            }
+            arcMap.push_back(a);
+        }
+        first[v + 1] = arcMap.size();
+    }
+
+    const unsigned m = arcMap.size();
+    head.resize(m);
+    reverse.resize(m);
+    capacity.resize(m);
+    edges.resize(m);
+    arcs.clear(); // arcOf() is only used on the whole
+    for (unsigned a = 0; a < m; a++) {
+        unsigned g = arcMap[a], h = whole.head[g], r = whole.reverse[g];
+        head[a] = h < 2 ? h : local[h];
+        capacity[a] = whole.capacity[g];
+        edges[a] = whole.edges[g];
+        reverse[a] = h < 2 ? terminal.at(r) : first[local[h]] + (r - whole.first[h]);
+    }
+}
+
+//! Time Complexity: O(V + E + n), Space Complexity: O(V + E + n)
+template<typename Cap>
+void BasicResidualGraph<Cap>::build(const BasicResidualGraph &base, unsigned vertexes, const std::vector<std::pair<unsigned, unsigned>> &added,
+                                    const std::vector<Cap> &capacities, std::vector<unsigned> &arcMap) {
+    Stats::add(STAT_ALLOCATIONS, 1);
+    const unsigned n = base.vertexCount() + vertexes;
+    std::vector<unsigned> degree(n, 0); // arcs added to each vertex
+    for (const std::pair<unsigned, unsigned> &arc: added) {
+        degree[arc.first]++;
+        degree[arc.second]++;
+    }
+    first.assign(n + 1, 0);
+    for (unsigned v = 0; v < n; v++)
+        first[v + 1] = first[v] + (v < base.vertexCount() ? base.first[v + 1] - base.first[v] : 0) + degree[v];
+
+    const unsigned m = first.back();
+    head.resize(m);
+    reverse.resize(m);
+    capacity.resize(m);
+    edges.resize(m);
+    arcs.clear(); // arcOf() is only used on the base
+    for (unsigned v = 0; v < base.vertexCount(); v++) {
+        for (unsigned a = base.first[v]; a < base.first[v + 1]; a++) {
+            unsigned b = first[v] + (a - base.first[v]);
+            head[b] = base.head[a];
+            reverse[b] = arcOfBase(base, base.reverse[a]);
+            capacity[b] = base.capacity[a];
+            edges[b] = base.edges[a];
+        }
+        degree[v] = base.first[v + 1] - base.first[v]; // from here on, the arcs each vertex already has
+    }
+    for (unsigned v = base.vertexCount(); v < n; v++)
+        degree[v] = 0;
+
+    arcMap.resize(added.size());
+    for (unsigned i = 0; i < added.size(); i++) {
+        unsigned tail = added[i].first, h = added[i].second;
+        unsigned f = first[tail] + degree[tail]++, r = first[h] + degree[h]++;
+        head[f] = h;
+        capacity[f] = capacities[i];
+        head[r] = tail;
+        capacity[r] = 0;
+        edges[f] = edges[r] = nullptr;
+        reverse[f] = r;
+        reverse[r] = f;
+        arcMap[i] = f;
+    }
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::loadBase(FlowState &extended, const BasicResidualGraph &base, const FlowState &s) const {
+    for (unsigned v = 0; v < vertexCount(); v++) {
+        unsigned kept = v < base.vertexCount() ? base.first[v + 1] - base.first[v] : 0;
+        for (unsigned a = first[v]; a < first[v + 1]; a++) {
+            bool added = a - first[v] >= kept;
+            extended.flow[a] = added ? 0 : s.flow[base.first[v] + (a - first[v])];
+            extended.removed[a] = added ? 1 : s.removed[base.first[v] + (a - first[v])];
+        }
+    }
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::arcOfBase(const BasicResidualGraph &base, unsigned a) const {
+    unsigned v = base.getTail(a);
+    return first[v] + (a - base.first[v]);
+}
+
+//! Time Complexity: O(E'), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::loadPart(FlowState &part, const FlowState &whole, const std::vector<unsigned> &arcMap) const {
+    for (unsigned a = 0; a < arcMap.size(); a++) {
+        part.flow[a] = whole.flow[arcMap[a]];
+        part.removed[a] = whole.removed[arcMap[a]];
+    }
+}
+
+//! Time Complexity: O(E'), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::storePart(FlowState &whole, const FlowState &part, const std::vector<unsigned> &arcMap) const {
+    for (unsigned a = 0; a < arcMap.size(); a++) {
+        unsigned g = arcMap[a];
+        if (edges[g] != nullptr && part.flow[a] != whole.flow[g])
+            push(whole, g, part.flow[a] - whole.flow[g]);
+    }
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+template<typename Cap>
+BasicFlowState<Cap> BasicResidualGraph<Cap>::newState() const {
+    Stats::add(STAT_ALLOCATIONS, 1);
+    FlowState s;
+    s.flow.assign(arcCount(), 0);
+    s.removed.assign(arcCount(), 0);
+    s.parent.assign(vertexCount(), 0);
+    s.visited.assign(vertexCount(), 0);
+    s.queue.resize(vertexCount());
+    s.stamp = 0;
+    return s;
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::load(FlowState &s) const {
+    for (unsigned a = 0; a < edges.size(); a++) {
+        if (edges[a] == nullptr) continue;
+        Cap delta = static_cast<Cap>(edges[a]->getFlow()) - s.flow[a];
+        if (delta != 0)
+            push(s, a, delta); // through push(), so that flows set directly on the edges are journaled too
+    }
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::store(const FlowState &s) const {
+    for (unsigned a = 0; a < edges.size(); a++)
+        if (edges[a] != nullptr)
+            edges[a]->setFlow(static_cast<Capacity>(s.flow[a]));
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::indexOf(const Vertex *v) const {
+    return v->getIndex();
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::arcOf(const Edge *e) const {
+    return arcs[e->getIndex()];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+Edge *BasicResidualGraph<Cap>::getEdge(unsigned a) const {
+    return edges[a];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::getTail(unsigned a) const {
+    return head[reverse[a]];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::getHead(unsigned a) const {
+    return head[a];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+Cap BasicResidualGraph<Cap>::getCapacity(unsigned a) const {
+    return capacity[a];
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+Cap BasicResidualGraph<Cap>::residual(const FlowState &s, unsigned a) const {
+    return (s.removed[a] ? 0 : capacity[a]) - s.flow[a];
+}
+
+//! Time Complexity: O(V * E²), Space Complexity: O(V)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::cutArc(FlowState &s, unsigned a) const {
+    Cap f = s.flow[a];
+    s.removed[a] = 1;
+    push(s, a, -f);
+    // flow that went around a cycle through the arc only has to be cancelled along the rest of the cycle;
+    // the remainder came from the source and went to the sink
+    Cap cycle = 0;
+    unsigned BFSes = reduceFlow(s, head[a], getTail(a), f, &cycle);
+    BFSes += reduceFlow(s, SOURCE_INDEX, getTail(a), f - cycle);
+    BFSes += reduceFlow(s, head[a], SINK_INDEX, f - cycle);
+    return BFSes;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::restoreArc(FlowState &s, unsigned a) const {
+    s.removed[a] = 0;
+}
+
+//! Time Complexity: depends on the algorithm, Space Complexity: O(V)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::maxFlow(FlowState &s, max_flow_algorithm algorithm) const {
+    unsigned iterations = 0;
+    switch (algorithm) {
+        case EDMONDS_KARP:
+            return edmondsKarp(s);
+        case FORD_FULKERSON:
+            fordFulkerson(s, &iterations);
+            return iterations;
+        case DINIC:
+            return dinic(s);
+        case PUSH_RELABEL:
+            return pushRelabel(s);
+    }
+    return iterations;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::vertexCount() const {
+    return first.size() - 1;
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::arcCount() const {
+    return head.size();
+}
+
+//! Time Complexity: O(1) amortized, Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::newSearch(FlowState &s) const {
+    if (++s.stamp == 0) { // the s.stamp wrapped around, old marks could be mistaken for new ones
+        std::fill(s.visited.begin(), s.visited.end(), 0);
+        s.stamp = 1;
+    }
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::push(FlowState &s, unsigned a, Cap delta) const {
+    s.flow[a] += delta;
+    s.flow[reverse[a]] -= delta;
+    if (s.journaling)
+        s.journal.emplace_back(a, delta);
+}
+
+//! Time Complexity: O(n), n being the number of pushes undone, Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::rollback(FlowState &s, size_t mark) const {
+    while (s.journal.size() > mark) {
+        const std::pair<unsigned, Cap> &p = s.journal.back();
+        s.flow[p.first] -= p.second;
+        s.flow[reverse[p.first]] += p.second;
+        s.journal.pop_back();
+    }
+}
+
+//! Time Complexity: O(V), Space Complexity: O(1)
+template<typename Cap>
+Cap BasicResidualGraph<Cap>::augmentPath(FlowState &s, unsigned src, unsigned dst, Cap limit, SolverCounters &counters) const {
+    Cap min = limit;
+    unsigned length = 0;
+    for (unsigned v = dst; v != src; v = head[reverse[s.parent[v]]], length++)
+        min = std::min(min, residual(s, s.parent[v]));
+    for (unsigned v = dst; v != src; v = head[reverse[s.parent[v]]])
+        push(s, s.parent[v], min);
+    counters.path(length);
+    return min;
+}
+
+//! Time Complexity: O(V * E²), Space Complexity: O(V)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::edmondsKarp(FlowState &s) const {
+    SolverCounters counters;
+    unsigned iterations = 0;
+    while (true) {
+        ++iterations;
+        counters.search();
+        newSearch(s);
+        s.visited[SOURCE_INDEX] = s.stamp;
+        unsigned front = 0, back = 0;
+        s.queue[back++] = SOURCE_INDEX;
+        bool found = false;
+        while (front < back && !found) { // BFS
+            unsigned v = s.queue[front++];
+            for (unsigned a = first[v]; a < first[v + 1]; a++) {
+                counters.scan();
+                unsigned d = head[a];
+                if (s.visited[d] == s.stamp || residual(s, a) <= 0) continue;
+                s.parent[d] = a;
+                if (d == SINK_INDEX) {
+                    found = true;
+                    break;
+                }
+                s.visited[d] = s.stamp;
+                s.queue[back++] = d;
+            }
+        } // BFS
+        if (!found)
+            return iterations;
+        augmentPath(s, SOURCE_INDEX, SINK_INDEX, std::numeric_limits<Cap>::max(), counters);
+    }
+}
+
+//! Time Complexity: O(E * f), Space Complexity: O(V)
+template<typename Cap>
+Cap BasicResidualGraph<Cap>::fordFulkerson(FlowState &s, unsigned *iterations) const {
+    SolverCounters counters;
+    for (unsigned a = 0; a < arcCount(); a++)
+        if (edges[a] != nullptr && s.flow[a] != 0)
+            push(s, a, -s.flow[a]);
+    std::vector<unsigned> next(vertexCount()); // current arc of each vertex in the DFS stack
+    Cap totalFlow = 0;
+    if (iterations != nullptr)
+        *iterations = 0;
+    while (true) {
+        if (iterations != nullptr)
+            ++*iterations;
+        counters.search();
+        newSearch(s);
+        s.visited[SOURCE_INDEX] = s.stamp;
+        next[SOURCE_INDEX] = first[SOURCE_INDEX];
+        unsigned top = 0;
+        s.queue[top++] = SOURCE_INDEX;
+        bool found = false;
+        while (top > 0 && !found) { // DFS
+            unsigned v = s.queue[top - 1];
+            if (next[v] == first[v + 1]) { // dead end
+                --top;
+                continue;
+            }
+            unsigned a = next[v]++;
+            counters.scan();
+            unsigned d = head[a];
+            if (s.visited[d] == s.stamp || residual(s, a) <= 0) continue;
+            s.parent[d] = a;
+            if (d == SINK_INDEX) {
+                found = true;
+                break;
+            }
+            s.visited[d] = s.stamp;
+            next[d] = first[d];
+            s.queue[top++] = d;
+        } // DFS
+        if (!found)
+            return totalFlow;
+        totalFlow += augmentPath(s, SOURCE_INDEX, SINK_INDEX, std::numeric_limits<Cap>::max(), counters);
+    }
+}
+
+//! Time Complexity: O(V² * E), Space Complexity: O(V)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::dinic(FlowState &s) const {
+    const unsigned UNREACHED = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> level(vertexCount()), next(vertexCount());
+    SolverCounters counters;
+    unsigned iterations = 0;
+    while (true) {
+        ++iterations;
+        counters.search();
+        std::fill(level.begin(), level.end(), UNREACHED);
+        level[SOURCE_INDEX] = 0;
+        unsigned front = 0, back = 0;
+        s.queue[back++] = SOURCE_INDEX;
+        while (front < back) { // BFS: level graph
+            unsigned v = s.queue[front++];
+            for (unsigned a = first[v]; a < first[v + 1]; a++) {
+                counters.scan();
+                unsigned d = head[a];
+                if (level[d] != UNREACHED || residual(s, a) <= 0) continue;
+                level[d] = level[v] + 1;
+                s.queue[back++] = d;
+            }
+        } // BFS
+        if (level[SINK_INDEX] == UNREACHED)
+            return iterations;
+
+        std::copy(first.begin(), first.end() - 1, next.begin());
+        while (true) { // blocking flow
+            unsigned top = 0;
+            s.queue[top++] = SOURCE_INDEX;
+            while (top > 0 && s.queue[top - 1] != SINK_INDEX) {
+                unsigned v = s.queue[top - 1];
+                while (next[v] < first[v + 1] &&
+                       (level[head[next[v]]] != level[v] + 1 || residual(s, next[v]) <= 0)) {
+                    counters.scan();
+                    ++next[v];
+                }
+                if (next[v] == first[v + 1]) { // dead end: no arc of this phase will reach it again
+                    level[v] = UNREACHED;
+                    --top;
+                    continue;
+                }
+                s.parent[head[next[v]]] = next[v];
+                s.queue[top++] = head[next[v]];
+            }
+            if (top == 0)
+                break;
+            augmentPath(s, SOURCE_INDEX, SINK_INDEX, std::numeric_limits<Cap>::max(), counters); // saturated arcs are skipped by the current arc loop
+        } // blocking flow
+    }
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(1)
+template<typename Cap>
+void BasicResidualGraph<Cap>::globalRelabel(FlowState &s, std::vector<unsigned> &height, std::vector<unsigned> &count,
+                                            SolverCounters &counters) const {
+    const unsigned n = vertexCount();
+    std::fill(height.begin(), height.end(), 2 * n);
+    std::fill(count.begin(), count.end(), 0);
+    height[SINK_INDEX] = 0;
+    height[SOURCE_INDEX] = n;
+    counters.search();
+    for (unsigned root: {SINK_INDEX, SOURCE_INDEX}) { // reverse BFS: u reaches v if the pair of an arc of v has residual capacity
+        unsigned front = 0, back = 0;
+        s.queue[back++] = root;
+        while (front < back) {
+            unsigned v = s.queue[front++];
+            for (unsigned a = first[v]; a < first[v + 1]; a++) {
+                counters.scan();
+                unsigned u = head[a];
+                if (height[u] != 2 * n || residual(s, reverse[a]) <= 0) continue;
+                height[u] = height[v] + 1;
+                s.queue[back++] = u;
+            }
+        }
+    }
+    for (unsigned v = 0; v < n; v++)
+        count[height[v]]++;
+}
+
+//! Time Complexity: O(V³), Space Complexity: O(V)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::pushRelabel(FlowState &s) const {
+    const unsigned n = vertexCount();
+    std::vector<unsigned> height(n), count(2 * n + 1), current(n);
+    std::vector<Cap> excess(n, 0);
+    std::vector<bool> active(n, false);
+    std::vector<unsigned> fifo(n); // ring buffer: a vertex is at most once in the queue
+    unsigned front = 0, size = 0;
+    SolverCounters counters;
+
+    // the current flow is valid, so saturating the source yields a preflow
+    for (unsigned a = first[SOURCE_INDEX]; a < first[SOURCE_INDEX + 1]; a++) {
+        Cap r = residual(s, a);
+        if (r <= 0) continue;
+        push(s, a, r);
+        excess[head[a]] += r;
+        excess[SOURCE_INDEX] -= r;
+        if (!active[head[a]] && head[a] != SINK_INDEX) {
+            active[head[a]] = true;
+            fifo[(front + size++) % n] = head[a];
+        }
+    }
+
+    unsigned globalRelabels = 1, work = 0;
+    globalRelabel(s, height, count, counters);
+    std::copy(first.begin(), first.end() - 1, current.begin());
+
+    while (size > 0) {
+        unsigned v = fifo[front];
+        front = (front + 1) % n;
+        --size;
+        active[v] = false;
+
+        while (excess[v] > 0 && height[v] < 2 * n) { // discharge
+            if (current[v] == first[v + 1]) { // relabel
+                unsigned old = height[v];
+                count[old]--;
+                if (count[old] == 0 && old < n) { // gap: the vertexes above it can no longer reach the sink
+                    for (unsigned u = 0; u < n; u++) {
+                        if (height[u] <= old || height[u] >= n) continue;
+                        count[height[u]]--;
+                        height[u] = n + 1;
+                        count[n + 1]++;
+                        current[u] = first[u];
+                    }
+                }
+                unsigned newHeight = 2 * n;
+                for (unsigned a = first[v]; a < first[v + 1]; a++) {
+                    counters.scan();
+                    if (residual(s, a) > 0)
+                        newHeight = std::min(newHeight, height[head[a]] + 1);
+                }
+                height[v] = newHeight;
+                count[newHeight]++;
+                current[v] = first[v];
+                work += first[v + 1] - first[v] + 12;
+                continue;
+            }
+
+            unsigned a = current[v], d = head[a];
+            counters.scan();
+            Cap r = residual(s, a);
+            if (r <= 0 || height[v] != height[d] + 1) {
+                ++current[v];
+                continue;
+            }
+            Cap delta = std::min(excess[v], r);
+            push(s, a, delta);
+            excess[v] -= delta;
+            excess[d] += delta;
+            if (!active[d] && d != SOURCE_INDEX && d != SINK_INDEX) {
+                active[d] = true;
+                fifo[(front + size++) % n] = d;
+            }
+        } // discharge
+
+        if (work > 6 * n + arcCount()) { // the heights drifted away from the real distances
+            globalRelabel(s, height, count, counters);
+            std::copy(first.begin(), first.end() - 1, current.begin());
+            ++globalRelabels;
+            work = 0;
+        }
+    }
+    return globalRelabels;
+}
+
+//! Time Complexity: O(V * E²), Space Complexity: O(V)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::reduceFlow(FlowState &s, unsigned src, unsigned dst, Cap limit, Cap *reduced) const {
+    unsigned BFSes = 1; // there is always at least one BFS
+    SolverCounters counters;
+    if (reduced != nullptr)
+        *reduced = 0;
+    while (limit > 0) {
+        counters.search();
+        newSearch(s);
+        s.visited[SOURCE_INDEX] = s.stamp;
+        s.visited[src] = s.stamp;
+        unsigned front = 0, back = 0;
+        s.queue[back++] = src;
+        bool found = false;
+        while (front < back && !found) { // BFS through the arcs carrying flow
+            unsigned v = s.queue[front++];
+            for (unsigned a = first[v]; a < first[v + 1]; a++) {
+                counters.scan();
+                unsigned d = head[a];
+                if (s.visited[d] == s.stamp || s.flow[a] <= 0) continue;
+                s.parent[d] = a;
+                if (d == dst) {
+                    found = true;
+                    break;
+                }
+                s.visited[d] = s.stamp;
+                s.queue[back++] = d;
+            }
+        } // BFS
+        if (!found)
+            return BFSes;
+        Cap min = limit;
+        unsigned length = 0;
+        for (unsigned v = dst; v != src; v = head[reverse[s.parent[v]]], length++)
+            min = std::min(min, s.flow[s.parent[v]]);
+        counters.path(length);
+        for (unsigned v = dst; v != src; v = head[reverse[s.parent[v]]])
+            push(s, s.parent[v], -min);
+        limit -= min;
+        if (reduced != nullptr)
+            *reduced += min;
+        ++BFSes;
+    }
+    return BFSes;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V)
+template<typename Cap>
+std::vector<unsigned> BasicResidualGraph<Cap>::minCut(FlowState &s, std::vector<bool> &sourceSide) const {
+    newSearch(s);
+    s.visited[SOURCE_INDEX] = s.stamp;
+    unsigned front = 0, back = 0;
+    s.queue[back++] = SOURCE_INDEX;
+    while (front < back) { // BFS
+        unsigned v = s.queue[front++];
+        for (unsigned a = first[v]; a < first[v + 1]; a++) {
+            unsigned d = head[a];
+            if (s.visited[d] == s.stamp || residual(s, a) <= 0) continue;
+            s.visited[d] = s.stamp;
+            s.queue[back++] = d;
+        }
+    } // BFS
+
+    sourceSide.assign(vertexCount(), false);
+    for (unsigned i = 0; i < back; i++)
+        sourceSide[s.queue[i]] = true;
+    std::vector<unsigned> cut;
+    for (unsigned a = 0; a < arcCount(); a++)
+        if (edges[a] != nullptr && !s.removed[a] && sourceSide[getTail(a)] && !sourceSide[head[a]])
+            cut.push_back(a);
+    return cut;
+}
+
+//! Time Complexity: O(E), Space Complexity: O(1)
+template<typename Cap>
+double BasicResidualGraph<Cap>::utilizationCost(const FlowState &s) const {
+    double cost = 0;
+    for (unsigned a = 0; a < arcCount(); a++)
+        if (edges[a] != nullptr && getTail(a) != SOURCE_INDEX && head[a] != SINK_INDEX && capacity[a] > 0)
+            cost += (double) s.flow[a] * (double) s.flow[a] / (double) capacity[a];
+    return cost;
+}
+
+//! Time Complexity: O(V² * E * log(C / EPSILON)), C being the largest marginal cost, Space Complexity: O(V + E)
+template<typename Cap>
+unsigned BasicResidualGraph<Cap>::balance(FlowState &s) const {
+    const unsigned n = vertexCount(), m = arcCount(), UNREACHED = ~0u;
+    const double EPSILON = 1e-9, SCALE = 4;
+    auto pipeOf = [&](unsigned a) { return edges[a] != nullptr ? a : reverse[a]; };
+    // cost of the next unit through an arc: the change of flow² / capacity of its pipe, nothing for the arcs from the source
+    auto cost = [&](unsigned a) {
+        unsigned p = pipeOf(a);
+        if (getTail(p) == SOURCE_INDEX)
+            return 0.0;
+        double f = (double) s.flow[p], c = (double) capacity[p];
+        return p == a ? (2 * f + 1) / c : (1 - 2 * f) / c;
+    };
+    std::vector<double> potential(n, 0);
+    auto reduced = [&](unsigned a) { return cost(a) + potential[getTail(a)] - potential[head[a]]; };
+    auto usable = [&](unsigned a) { return head[pipeOf(a)] != SINK_INDEX && residual(s, a) > 0; }; // the arcs to the sink are left alone
+    // units the arc takes before the next one stops having a negative reduced cost, so whole flows stay whole
+    auto admissible = [&](unsigned a) -> Cap {
+        unsigned p = pipeOf(a);
+        if (!usable(a))
+            return 0;
+        if (getTail(p) == SOURCE_INDEX)
+            return reduced(a) < 0 ? residual(s, a) : 0;
+        // the next unit costs less than the difference of the potentials up to flow t, where the marginal cost meets it
+        double c = (double) capacity[p], t = ((potential[head[p]] - potential[getTail(p)]) * c - 1) / 2;
+        Cap goal = p == a ? (Cap) std::min(c, std::ceil(t)) : (Cap) std::max(0.0, std::floor(t) + 1);
+        return std::max(p == a ? goal - s.flow[p] : s.flow[p] - goal, (Cap) 0);
+    };
+
+    std::vector<Cap> excess(n, 0); // water each vertex gets minus the water it sends, 0 for a valid flow
+    unsigned pushes = 0, front = 0, size = 0; // s.queue is a ring of the vertexes with an excess
+    auto move = [&](unsigned a, Cap units) {
+        push(s, a, units);
+        excess[getTail(a)] -= units;
+        if (excess[head[a]] <= 0 && excess[head[a]] + units > 0)
+            s.queue[(front + size++) % n] = head[a];
+        excess[head[a]] += units;
+        ++pushes;
+    };
+
+    // global update: Dial's buckets on the distances to the nearest deficit, in steps of epsilon, over the reversed arcs;
+    // each vertex settled is raised by epsilon per step it is nearer than the last excess, the others keep their potentials
+    std::vector<unsigned> distance(n, UNREACHED), current(n), reached, settled;
+    std::vector<std::vector<unsigned>> buckets(n + 1);
+    std::vector<bool> done(n, false);
+    double epsilon = 0; // the flow is epsilon-optimal: no arc that can take a unit has a reduced cost below -epsilon
+    auto update = [&]() {
+        unsigned active = 0, last = 0;
+        for (unsigned v = 0; v < n; v++) {
+            active += excess[v] > 0;
+            if (excess[v] < 0) {
+                distance[v] = 0;
+                reached.push_back(v);
+                buckets[0].push_back(v);
+            }
+        }
+        for (unsigned d = 0; d <= n && active > 0; d++) {
+            for (unsigned i = 0; i < buckets[d].size() && active > 0; i++) {
+                unsigned w = buckets[d][i];
+                if (distance[w] != d || done[w]) continue;
+                done[w] = true;
+                settled.push_back(w);
+                last = d;
+                active -= excess[w] > 0;
+                for (unsigned b = first[w]; b < first[w + 1]; b++) {
+                    unsigned a = reverse[b], u = head[b]; // a goes from u to w
+                    if (done[u] || !usable(a)) continue;
+                    double length = std::max(0.0, std::floor(reduced(a) / epsilon) + 1);
+                    if (d + length > n || d + (unsigned) length >= distance[u]) continue;
+                    if (distance[u] == UNREACHED)
+                        reached.push_back(u);
+                    distance[u] = d + (unsigned) length;
+                    buckets[distance[u]].push_back(u);
+                }
+            }
+        }
+        for (unsigned v: settled) {
+            potential[v] += epsilon * (double) (last - distance[v]);
+            done[v] = false;
+        }
+        for (unsigned v: reached) {
+            buckets[distance[v]].clear();
+            distance[v] = UNREACHED;
+        }
+        reached.clear();
+        settled.clear();
+        for (unsigned v = 0; v < n; v++)
+            current[v] = first[v];
+    };
+
+    for (unsigned a = 0; a < m; a++)
+        if (admissible(a) > 0)
+            epsilon = std::max(epsilon, -reduced(a));
+    // cost scaling: each refinement makes an epsilon-optimal flow (epsilon / SCALE)-optimal, down to EPSILON, where it is optimal
+    while (epsilon > EPSILON) {
+        epsilon = std::max(epsilon / SCALE, EPSILON);
+        for (unsigned a = 0; a < m; a++) { // every arc takes the units with a negative reduced cost, leaving excesses and deficits
+            Cap units = admissible(a);
+            if (units > 0)
+                move(a, units);
+        }
+
+        // push-relabel: the excesses go through the arcs with a negative reduced cost, and a vertex with none lowers
+        // its potential until the cheapest of them costs -epsilon, with a global update every n / 4 relabels
+        update();
+        unsigned relabels = 0;
+        while (size > 0) {
+            unsigned v = s.queue[front];
+            front = (front + 1) % n;
+            --size;
+            if (v == SOURCE_INDEX && size > 0) { // the water the reservoirs give back goes out in one pass
+                s.queue[(front + size++) % n] = v;
+                continue;
+            }
+            while (excess[v] > 0) {
+                if (current[v] == first[v + 1]) {
+                    double highest = -std::numeric_limits<double>::infinity();
+                    for (unsigned a = first[v]; a < first[v + 1]; a++)
+                        if (usable(a))
+                            highest = std::max(highest, potential[head[a]] - cost(a));
+                    potential[v] = std::min(highest, potential[v]) - epsilon; // lower even if rounding errors hid an arc
+                    current[v] = first[v];
+                    if (++relabels >= n / 4) {
+                        relabels = 0;
+                        update();
+                    }
+                    continue;
+                }
+                Cap units = admissible(current[v]);
+                if (units > 0)
+                    move(current[v], std::min(units, excess[v]));
+                if (excess[v] > 0)
+                    current[v]++;
+            }
+        }
+    }
+    return pushes;
+}
+
+template class BasicResidualGraph<double>;
+template class BasicResidualGraph<int64_t>;
+template class BasicResidualGraph<int32_t>;
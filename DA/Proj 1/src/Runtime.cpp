@@ -6,24 +6,62 @@
  */
 
 #include "../lib/Runtime.hpp"
+#include "../lib/Stats.hpp"
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
 
 Runtime::Runtime(Graph *graph): network(*graph) {}
 
-static void print_pipes_statistics(const Graph &g);
+Runtime::~Runtime() {
+    stopWarming();
+}
+
+const Graph &Runtime::getNetwork() const {
+    return network;
+}
+
+void Runtime::startWarming() {
+    std::vector<Vertex *> cities;
+    for (auto p: network.getCityVertexes())
+        if (!network.isDependencyKnown(p.second))
+            cities.push_back(p.second);
+    if (cities.empty()) return;
+    std::sort(cities.begin(), cities.end(), [](const Vertex *a, const Vertex *b) {
+        if (a->getPopulation() != b->getPopulation()) return a->getPopulation() > b->getPopulation();
+        return a->getTypeId() < b->getTypeId();
+    });
+    stopWarmer = false;
+    warmer = std::thread([this, cities]() {
+        for (Vertex *city: cities) {
+            if (stopWarmer) return;
+            network.getDependency(city);
+        }
+    });
+}
+
+void Runtime::stopWarming() {
+    if (!warmer.joinable()) return;
+    stopWarmer = true;
+    warmer.join();
+}
 
 void Runtime::run(){
     std::cout << WHITE << "\nWelcome to our project!\nType " << GREEN << "help" << WHITE << " to learn the available commands." << std::endl;
     while(true){
         if (std::cin.eof()) break; // CTRL-D
-        std::cout << "> ";
+        std::cout << "> " << std::flush;
+        startWarming();
         std::vector<std::string> command = readCommand();
+        stopWarming();
         if (command.empty()) continue;
         std::cout << std::endl;
         if (command[0] == "exit") break;
-        else if(command[0] == "help") help(command);
+        PhaseTimer timer("command", command[0]);
+        if(command[0] == "help") help(command);
         else if(command[0] == "display_city") displayCity(command);
         else if(command[0] == "display_reservoir") displayReservoir(command);
         else if(command[0] == "display_station") displayStation(command);
@@ -31,9 +69,21 @@ void Runtime::run(){
         else if(command[0] == "remove") remove(command);
         else if(command[0] == "remove_pipe") removePipe(command);
         else if(command[0] == "restore") restore(command);
+        else if(command[0] == "checkpoint") checkpoint(command);
+        else if(command[0] == "rollback") rollback(command);
         else if(command[0] == "show_dependency") showDependency(command);
         else if(command[0] == "pipes_statistics") print_pipes_statistics(network);
+        else if(command[0] == "algorithm") algorithm(command);
+        else if(command[0] == "k_failures") kFailures(command);
+        else if(command[0] == "simulate") simulate(command);
+        else if(command[0] == "estimate") estimate(command);
+        else if(command[0] == "bottlenecks") bottlenecks(command);
+        else if(command[0] == "balance") balance(command);
+        else if(command[0] == "upgrade_pipe" || command[0] == "add_pipe" || command[0] == "add_reservoir") upgrade(command);
+        else if(command[0] == "evaluate_upgrades") evaluateUpgrades(command);
+        else if(command[0] == "stats") stats(command);
         else{
+            timer.discard();
             std::cout << RED << "Error:" << WHITE << "No such command. Type " << GREEN << "help" << WHITE << " to learn the available commands.\n";
         }
     }
@@ -42,35 +92,154 @@ void Runtime::run(){
 }
 
 /**
- * @brief Prints statistics about the pipes
- * @param const Graph& g: graph
+ * @brief Writes a string as a JSON string, escaping quotes, backslashes and control characters
+ * @param std::ostream& out: stream
+ * @param const std::string& text: string
  * @return void
  * @note This function is static
- * @note Time Complexity: O(E * log E + V), Space Complexity: O(1)
+ * @note Time Complexity: O(n), Space Complexity: O(1)
  */
-void Runtime::print_pipes_statistics(const Graph &g) {
-    size_t n = 0;
-    double mean = 0, variance = 0, standard_deviation = 0, median = 0, q1 = 0, q3 = 0, aqi = 0, maximum_amplitude = 0;
-    size_t n_empty = 0, n_full = 0;
+static void writeJson(std::ostream &out, const std::string &text) {
+    out << '"';
+    for (char c: text) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c == '\n') out << "\\n";
+        else if ((unsigned char) c < 0x20) out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int) c << std::dec << std::setfill(' ');
+        else out << c;
+    }
+    out << '"';
+}
+
+void Runtime::runBatch(std::istream &in, std::ostream &out) {
+    //! A remove, remove_pipe or restore waiting for the other commands of its block
+    struct Job {
+        unsigned line;
+        std::string command, error;
+        unsigned scenario;                              // scenario of the job, if there is no error
+    };
+    std::vector<Job> jobs;
+    std::vector<std::vector<FailurePoint>> scenarios;
+    std::vector<FailurePoint> removed;                  // removals since the last restore, not applied to the network yet
+
+    std::streamsize precision = out.precision(15);
+    auto begin = [&out](unsigned line, const std::string &command) {
+        out << "{\"line\":" << line << ",\"command\":";
+        writeJson(out, command);
+    };
+    auto fail = [&out](const std::string &error) {
+        out << ",\"ok\":false,\"error\":";
+        writeJson(out, error);
+        out << "}\n";
+    };
+    // evaluates the jobs of the block, then applies the removals that were not restored, as the interactive commands would
+    auto flush = [&]() {
+        if (jobs.empty()) return;
+        std::vector<RemovalReport> reports = network.evaluateRemovals(scenarios);
+        for (const Job &job: jobs) {
+            begin(job.line, job.command);
+            if (!job.error.empty()) {
+                fail(job.error);
+                continue;
+            }
+            out << ",\"ok\":true";
+            writeRemoval(out, reports[job.scenario], job.command != "restore");
+            out << "}\n";
+        }
+        for (const FailurePoint &point: removed) {
+            if (point.pipe != nullptr) network.removeEdge(point.pipe->getOrig(), point.pipe->getDest());
+            else network.removeVertex(point.station);
+        }
+        if (!removed.empty()) network.maxFlow();
+        jobs.clear();
+        scenarios.clear();
+        removed.clear();
+    };
+
+    std::string line;
+    for (unsigned number = 1; getline(in, line); number++) {
+        std::istringstream iss(line);
+        std::vector<std::string> command;
+        std::string arg;
+        while (iss >> arg) command.push_back(arg);
+        if (command.empty() || command[0][0] == '#') continue;
+        if (command[0] == "exit") break;
+
+        if (command[0] == "remove" || command[0] == "remove_pipe") {
+            Job job{number, command[0], "", (unsigned) scenarios.size()};
+            FailurePoint point{nullptr, nullptr};
+            if (parseRemoval(command, removed, point, job.error)) {
+                removed.push_back(point);
+                scenarios.push_back(removed);
+            }
+            jobs.push_back(job);
+            continue;
+        }
+        if (command[0] == "restore" && command.size() == 1 && network.getRemovedVertexes().empty() && network.getRemovedEdges().empty()) {
+            jobs.push_back({number, command[0], "", (unsigned) scenarios.size()});
+            removed.clear();
+            scenarios.emplace_back();
+            continue;
+        }
+
+        flush();
+        begin(number, command[0]);
+        PhaseTimer timer("command", command[0]);
+        if (command[0] == "restore") { // it also undoes removals applied before this block
+            if (command.size() != 1) {
+                timer.discard();
+                fail("expected no arguments.");
+                continue;
+            }
+            network.restore();
+            network.maxFlow();
+            out << ",\"ok\":true,\"flow\":" << network.getFlow() << "}\n";
+            continue;
+        }
+        std::ostringstream fields;
+        fields.precision(15);
+        std::string error;
+        if (batchQuery(command, fields, error)) {
+            out << ",\"ok\":true" << fields.str() << "}\n";
+        } else {
+            timer.discard();
+            fail(error);
+        }
+    }
+    flush();
+    out.precision(precision);
+    out.flush();
+}
+
+/**
+ * @brief Calculates statistics about the pipes
+ * @param const Graph& g: graph
+ * @return PipeStatistics: statistics of the flow/capacity ratio of the pipes
+ * @note This function is static
+ * @note Time Complexity: O(E * log E + V), Space Complexity: O(E)
+ */
+PipeStatistics Runtime::pipes_statistics(const Graph &g) {
+    PipeStatistics statistics;
+    size_t &n = statistics.pipes;
+    double &mean = statistics.mean, &variance = statistics.variance;
     std::vector<double> sorted;
     double ratio = 0;
     for (Vertex *v: g.getVertexSet()) {
         for (Edge *e: v->getAdj()) {
-            ratio = e->getFlow() / e->getWeight();
+            ratio = (double) e->getFlow() / (double) e->getWeight();
             sorted.push_back(ratio);
             mean += ratio;
             n++;
             if (e->getFlow() == 0)
-                n_empty++;
+                statistics.empty++;
             else if (e->getFlow() == e->getWeight())
-                n_full++;
+                statistics.full++;
         }
     }
     for (auto p : g.getCityVertexes()) {
         Edge *e = p.second->getAdj()[0]; // this is not an actual pipe, it's an auxiliary edge
-        if (e->getFlow() == 0) n_empty--;
-        else if (e->getFlow() == e->getWeight()) n_full--;
-        mean -= e->getFlow() / e->getWeight();
+        if (e->getFlow() == 0) statistics.empty--;
+        else if (e->getFlow() == e->getWeight()) statistics.full--;
+        mean -= (double) e->getFlow() / (double) e->getWeight();
     }
     n -= g.getCityVertexes().size();
     mean /= n;
@@ -79,25 +248,36 @@ void Runtime::print_pipes_statistics(const Graph &g) {
         variance += std::pow(ratio - mean, 2);
 
     variance /= (double) (n - 1);
-    standard_deviation = std::pow(variance, 0.5);
-    median = (n % 2) ? sorted[(n + 1) / 2] : (sorted[n / 2] + sorted[n / 2 - 1]) / 2;
-    q1 = (n % 4) ? sorted[(n + 1) / 4] : (sorted[n / 4] + sorted[n / 4 - 1]) / 2;
-    q3 = (n % 4) ? sorted[3 * (n + 1) / 4] : (sorted[3 * n / 4] + sorted[3 * n / 4 - 1]) / 2;
-    aqi = q3 - q1;
-    maximum_amplitude = sorted[n - 1] - sorted[0];
+    statistics.standard_deviation = std::pow(variance, 0.5);
+    statistics.median = (n % 2) ? sorted[(n + 1) / 2] : (sorted[n / 2] + sorted[n / 2 - 1]) / 2;
+    statistics.q1 = (n % 4) ? sorted[(n + 1) / 4] : (sorted[n / 4] + sorted[n / 4 - 1]) / 2;
+    statistics.q3 = (n % 4) ? sorted[3 * (n + 1) / 4] : (sorted[3 * n / 4] + sorted[3 * n / 4 - 1]) / 2;
+    statistics.aqi = statistics.q3 - statistics.q1;
+    statistics.maximum_amplitude = sorted[n - 1] - sorted[0];
+    return statistics;
+}
 
+/**
+ * @brief Prints statistics about the pipes
+ * @param const Graph& g: graph
+ * @return void
+ * @note This function is static
+ * @note Time Complexity: O(E * log E + V), Space Complexity: O(E)
+ */
+void Runtime::print_pipes_statistics(const Graph &g) {
+    PipeStatistics statistics = pipes_statistics(g);
     std::cout << MAGENTA << "Statistics (flow / capacity)\n";
-    std::cout << YELLOW << std::setw(20) << "Number of pipes: " << WHITE << n << '\n';
-    std::cout << YELLOW << std::setw(20) << "Mean: " << WHITE << mean << '\n';
-    std::cout << YELLOW << std::setw(20) << "Variance: " << WHITE << variance << '\n';
-    std::cout << YELLOW << std::setw(20) << "Standard Deviation: " << WHITE << standard_deviation << '\n';
-    std::cout << YELLOW << std::setw(20) << "Median: " << WHITE << median << '\n';
-    std::cout << YELLOW << std::setw(20) << "Q1: " << WHITE << q1 << '\n';
-    std::cout << YELLOW << std::setw(20) << "Q3: " << WHITE << q3 << '\n';
-    std::cout << YELLOW << std::setw(20) << "AQI: " << WHITE << aqi << '\n';
-    std::cout << YELLOW << std::setw(20) << "Maximum Amplitude: " << WHITE << maximum_amplitude << '\n';
-    std::cout << YELLOW << std::setw(20) << "Empty Pipes: " << WHITE << n_empty << '\n';
-    std::cout << YELLOW << std::setw(20) << "Full Pipes: " << WHITE << n_full << '\n';
+    std::cout << YELLOW << std::setw(20) << "Number of pipes: " << WHITE << statistics.pipes << '\n';
+    std::cout << YELLOW << std::setw(20) << "Mean: " << WHITE << statistics.mean << '\n';
+    std::cout << YELLOW << std::setw(20) << "Variance: " << WHITE << statistics.variance << '\n';
+    std::cout << YELLOW << std::setw(20) << "Standard Deviation: " << WHITE << statistics.standard_deviation << '\n';
+    std::cout << YELLOW << std::setw(20) << "Median: " << WHITE << statistics.median << '\n';
+    std::cout << YELLOW << std::setw(20) << "Q1: " << WHITE << statistics.q1 << '\n';
+    std::cout << YELLOW << std::setw(20) << "Q3: " << WHITE << statistics.q3 << '\n';
+    std::cout << YELLOW << std::setw(20) << "AQI: " << WHITE << statistics.aqi << '\n';
+    std::cout << YELLOW << std::setw(20) << "Maximum Amplitude: " << WHITE << statistics.maximum_amplitude << '\n';
+    std::cout << YELLOW << std::setw(20) << "Empty Pipes: " << WHITE << statistics.empty << '\n';
+    std::cout << YELLOW << std::setw(20) << "Full Pipes: " << WHITE << statistics.full << '\n';
     std::cout << ANSI_RESET << "\n";
 }
 
@@ -155,11 +335,54 @@ void Runtime::help(std::vector<std::string> args){
               << "    " << GREEN << "restore:" << CYAN << "           takes no arguments" << WHITE << std::endl
               << "        Undoes the previous removal. The network will be as in the beginning."
               << std::endl << std::endl
+              << "    " << GREEN << "checkpoint:" << CYAN << "        takes no arguments" << WHITE << std::endl
+              << "        Saves the current removals and flow, so that the " << GREEN << "rollback" << WHITE << " command can go back to them. Checkpoints can be nested."
+              << std::endl << std::endl
+              << "    " << GREEN << "rollback:" << CYAN << "          takes 0 or 1 argument" << YELLOW << " rollback [n]" << WHITE << std::endl
+              << "        Goes back to the n-th newest checkpoint (the newest by default), undoing only the changes made after it."
+              << std::endl << std::endl
               << "    " << GREEN << "show_dependency:" << CYAN << "   takes 1 argument" << YELLOW << "    show_dependency <city_id>" << WHITE << std::endl
               << "        For a given City, shows which Pipelines, if ruptured, would affect the amount of water reaching the City."
               << std::endl << std::endl
               << "    " << GREEN << "pipes_statistics:" << CYAN << "  takes no arguments" << WHITE << std::endl
               << "        Displays statistics about the flow/capacity ratio of the pipes, like their average ratio, amount of empty/full pipes, etc."
+              << std::endl << std::endl
+              << "    " << GREEN << "algorithm:" << CYAN << "         takes 0 or 1 argument" << YELLOW << " algorithm [edmonds_karp | ford_fulkerson | dinic | push_relabel]" << WHITE << std::endl
+              << "        Shows the maximum flow algorithm used after removals and restores, or selects another one."
+              << std::endl << std::endl
+              << "    " << GREEN << "k_failures:" << CYAN << "        takes 1 or 2 arguments" << YELLOW << " k_failures <k> [n]" << WHITE << std::endl
+              << "        For every combination of k (1 to 3) Pipes or Pumping Stations failing at the same time, ranks the n (5 by default) that take the most water from each City."
+              << std::endl << std::endl
+              << "    " << GREEN << "simulate:" << CYAN << "          takes 2 to 4 arguments" << YELLOW << " simulate <samples> <probability> [percentile] [seed]" << WHITE << std::endl
+              << "        Makes each Pipe fail with that probability in many random samples, and prints the expected water missing in each City and at a percentile (0.95 by default) of the samples. The same seed (1 by default) gives the same results."
+              << std::endl << std::endl
+              << "    " << GREEN << "estimate:" << CYAN << "          takes 1 or 2 arguments" << YELLOW << " estimate <code> | estimate <code_origin> <code_destination>" << WHITE << std::endl
+              << "        Without removing anything, prints the Cities whose water goes through that location or Pipe, and the most water its removal can take from the network, from the paths the water currently follows." << std::endl
+              << "        Use " << GREEN << "remove" << WHITE << " or " << GREEN << "remove_pipe" << WHITE << " for the exact numbers once the water is rerouted."
+              << std::endl << std::endl
+              << "    " << GREEN << "bottlenecks:" << CYAN << "       takes no arguments" << WHITE << std::endl
+              << "        Prints the saturated Pipes and Reservoirs of the minimum cut of the current flow, grouped by the Cities missing water behind them."
+              << std::endl << std::endl
+              << "    " << GREEN << "balance:" << CYAN << "           takes no arguments" << WHITE << std::endl
+              << "        Spreads the water over the Pipes as evenly as their capacities allow, keeping the water reaching each City, and prints the Pipe statistics before and after."
+              << std::endl << std::endl
+              << "    " << GREEN << "upgrade_pipe:" << CYAN << "      takes 3 arguments" << YELLOW << "   upgrade_pipe <code_origin> <code_destination> <capacity>" << WHITE << std::endl
+              << "        Raises the capacity of a Pipe and prints the water each City gains, starting from the current flow."
+              << std::endl << std::endl
+              << "    " << GREEN << "add_pipe:" << CYAN << "          takes 3 arguments" << YELLOW << "   add_pipe <code_origin> <code_destination> <capacity>" << WHITE << std::endl
+              << "        Adds a Pipe between two locations and prints the water each City gains, starting from the current flow."
+              << std::endl << std::endl
+              << "    " << GREEN << "add_reservoir:" << CYAN << "     takes 4 arguments" << YELLOW << "   add_reservoir <code> <max_delivery> <code_destination> <capacity>" << WHITE << std::endl
+              << "        Adds a Reservoir with a Pipe to a location and prints the water each City gains, starting from the current flow." << std::endl
+              << "        Additions are kept by the " << GREEN << "restore" << WHITE << " command and discard every checkpoint."
+              << std::endl << std::endl
+              << "    " << GREEN << "evaluate_upgrades:" << CYAN << " takes 1 argument" << YELLOW << "    evaluate_upgrades <file>" << WHITE << std::endl
+              << "        Reads one " << GREEN << "upgrade_pipe" << WHITE << ", " << GREEN << "add_pipe" << WHITE << " or " << GREEN << "add_reservoir" << WHITE << " command per line, evaluates each one on its own without changing the network, and ranks them by the water gained."
+              << std::endl << std::endl
+              << "    " << GREEN << "stats:" << CYAN << "             takes 0 to 2 arguments" << YELLOW << " stats [reset | json <file>]" << WHITE << std::endl
+              << "        Prints the counters of the maximum flow algorithms and the time spent parsing, in the maximum flow, in the dependencies and in each command."
+              << std::endl
+              << "        " << GREEN << "reset" << WHITE << " sets them back to zero, " << GREEN << "json" << WHITE << " writes them to a file."
               << std::endl << std::endl;
 }
 
@@ -238,7 +461,7 @@ void Runtime::displayStation(std::vector<std::string> args) {
         std::sort(stations.begin(), stations.end(), [] (Vertex * s1, Vertex * s2) {return s1->getTypeId() < s2->getTypeId();});
         for (Vertex *station: stations) {
             std::cout << "  " << "Station " << std::setw(2) << station->getTypeId() << std::endl;
-            double passing = 0;
+            Capacity passing = 0;
             for (Edge *e: station->getIncoming()) passing += e->getFlow();
             std::cout << "     Water passing: " << passing << std::endl;
         }
@@ -247,7 +470,7 @@ void Runtime::displayStation(std::vector<std::string> args) {
             unsigned int id = std::stoul(args[1]);
             Vertex *station = network.getStationVertexes().at(id);
             std::cout << "  " << "Station " << std::setw(2) << station->getTypeId() << std::endl;
-            double passing = 0;
+            Capacity passing = 0;
             for (Edge *e: station->getIncoming()) passing += e->getFlow();
             std::cout << "     Water passing: " << passing << std::endl;
         }catch(...){
@@ -262,7 +485,7 @@ void Runtime::needyCities(std::vector<std::string> args) {
         return;
     }
 
-    double totalDemand = 0, totalReaching = 0, totalMissing = 0;
+    Capacity totalDemand = 0, totalReaching = 0, totalMissing = 0;
     for (auto city: network.getCityVertexes()) {
         if (city.second->getDemand() > city.second->getAdj()[0]->getFlow()) { // If the city's demand is higher than the water reaching it
             std::cout << "  " << std::setw(2) << city.second->getTypeId() << ": " << city.second->getCity() << std::endl;
@@ -281,20 +504,19 @@ void Runtime::needyCities(std::vector<std::string> args) {
     std::cout << "     Missing: " << RED << totalMissing << WHITE << std::endl;
 }
 
-void Runtime::printAffected(Graph &graph, const std::vector<Vertex *>& affectedCities, const std::vector<Vertex *>& affectedReservoirs) {
+void Runtime::printAffected(const FlowState &before, const std::vector<Vertex *>& affectedCities, const std::vector<Vertex *>& affectedReservoirs) {
     if (!affectedCities.empty()) {
         std::cout << YELLOW << "Affected Cities:" << WHITE << std::endl;
         for (Vertex *city: affectedCities) {
             std::cout << "  " << std::setw(2) << city->getTypeId() << ": " << city->getCity() << std::endl
                       << "     Flow before removal: "
-                      << graph.getCityVertexes().at(city->getTypeId())->getAdj()[0]->getFlow()
+                      << network.getEdgeFlow(before, city->getAdj()[0])
                       << std::endl
                       << "     Flow after removal: "
-                      << network.getCityVertexes().at(city->getTypeId())->getAdj()[0]->getFlow()
+                      << city->getAdj()[0]->getFlow()
                       << std::endl
                       << "     Difference: "
-                      << graph.getCityVertexes().at(city->getTypeId())->getAdj()[0]->getFlow() -
-                         network.getCityVertexes().at(city->getTypeId())->getAdj()[0]->getFlow()
+                      << network.getEdgeFlow(before, city->getAdj()[0]) - city->getAdj()[0]->getFlow()
                       << std::endl;
         }
         std::cout << std::endl;
@@ -304,14 +526,13 @@ void Runtime::printAffected(Graph &graph, const std::vector<Vertex *>& affectedC
         for (Vertex *reservoir: affectedReservoirs) {
             std::cout << "  " << std::setw(2) << reservoir->getTypeId() << ": " << reservoir->getReservoir() << std::endl
                       << "     Flow before removal: "
-                      << graph.getReservoirVertexes().at(reservoir->getTypeId())->getIncoming()[0]->getFlow()
+                      << network.getEdgeFlow(before, reservoir->getIncoming()[0])
                       << std::endl
                       << "     Flow after removal: "
-                      << network.getReservoirVertexes().at(reservoir->getTypeId())->getIncoming()[0]->getFlow()
+                      << reservoir->getIncoming()[0]->getFlow()
                       << std::endl
                       << "     Difference: "
-                      << graph.getReservoirVertexes().at(reservoir->getTypeId())->getIncoming()[0]->getFlow() -
-                         network.getReservoirVertexes().at(reservoir->getTypeId())->getIncoming()[0]->getFlow()
+                      << network.getEdgeFlow(before, reservoir->getIncoming()[0]) - reservoir->getIncoming()[0]->getFlow()
                       << std::endl;
         }
         std::cout << std::endl;
@@ -336,25 +557,25 @@ void Runtime::remove(std::vector<std::string> args) {
         return;
     }
 
-    Graph graph = network;
-    network.removeVertex(v->getId());
-    network.edmondsKarp();
+    FlowState before = network.getState();
+    network.removeVertex(v);
+    network.maxFlow();
     std::vector<Vertex *> affectedCities;
     std::vector<Vertex *> affectedReservoirs;
     for (auto c: network.getCityVertexes()) {
-        if (c.second->getAdj()[0]->getFlow() != graph.getCityVertexes().at(c.second->getTypeId())->getAdj()[0]->getFlow()) {
+        if (c.second->getAdj()[0]->getFlow() != network.getEdgeFlow(before, c.second->getAdj()[0])) {
             affectedCities.push_back(c.second);
         }
     }
     for (auto r: network.getReservoirVertexes()) {
-        if (r.second->getIncoming()[0]->getFlow() != graph.getReservoirVertexes().at(r.second->getTypeId())->getIncoming()[0]->getFlow()) {
+        if (r.second->getIncoming()[0]->getFlow() != network.getEdgeFlow(before, r.second->getIncoming()[0])) {
             affectedReservoirs.push_back(r.second);
         }
     }
 
-    if (v->getType() == CITY) printAffected(graph, {}, affectedReservoirs);
-    if (v->getType() == RESERVOIR) printAffected(graph, affectedCities, {});
-    if (v->getType() == STATION) printAffected(graph, affectedCities, affectedReservoirs);
+    if (v->getType() == CITY) printAffected(before, {}, affectedReservoirs);
+    if (v->getType() == RESERVOIR) printAffected(before, affectedCities, {});
+    if (v->getType() == STATION) printAffected(before, affectedCities, affectedReservoirs);
 }
 
 void Runtime::removePipe(std::vector<std::string> args) {
@@ -388,23 +609,23 @@ void Runtime::removePipe(std::vector<std::string> args) {
         return;
     }
 
-    Graph graph = network;
+    FlowState before = network.getState();
     network.removeEdge(v, d);
-    network.edmondsKarp();
+    network.maxFlow();
     std::vector<Vertex *> affectedCities;
     std::vector<Vertex *> affectedReservoirs;
     for (auto c: network.getCityVertexes()) {
-        if (c.second->getAdj()[0]->getFlow() != graph.getCityVertexes().at(c.second->getTypeId())->getAdj()[0]->getFlow()) {
+        if (c.second->getAdj()[0]->getFlow() != network.getEdgeFlow(before, c.second->getAdj()[0])) {
             affectedCities.push_back(c.second);
         }
     }
     for (auto r: network.getReservoirVertexes()) {
-        if (r.second->getIncoming()[0]->getFlow() != graph.getReservoirVertexes().at(r.second->getTypeId())->getIncoming()[0]->getFlow()) {
+        if (r.second->getIncoming()[0]->getFlow() != network.getEdgeFlow(before, r.second->getIncoming()[0])) {
             affectedReservoirs.push_back(r.second);
         }
     }
 
-    printAffected(graph, affectedCities, affectedReservoirs);
+    printAffected(before, affectedCities, affectedReservoirs);
 }
 
 void Runtime::restore(std::vector<std::string> args) {
@@ -413,15 +634,47 @@ void Runtime::restore(std::vector<std::string> args) {
         return;
     }
     network.restore();
-    network.edmondsKarp();
+    network.maxFlow();
 }
 
-void Runtime::showDependency(std::vector<std::string> args) {
-    if (!network.getRemovedVertexes().empty() or !network.getRemovedEdges().empty()) {
-        std::cout << RED << "Warning:" << WHITE << "Please, restore the graph before removing anything else." << std::endl;
+void Runtime::checkpoint(std::vector<std::string> args) {
+    if (args.size() != 1) {
+        std::cout << RED << "Error: expected no arguments." << ANSI_RESET << std::endl;
+        return;
+    }
+    unsigned n = network.checkpoint();
+    std::cout << "Checkpoint " << GREEN << n << WHITE << " saved." << std::endl;
+}
+
+void Runtime::rollback(std::vector<std::string> args) {
+    if (args.size() > 2) {
+        std::cout << RED << "Error: expected at most 1 argument." << ANSI_RESET << std::endl;
         return;
     }
 
+    unsigned n = 1;
+    if (args.size() == 2) {
+        try {
+            n = stoul(args[1]);
+        } catch (...) {
+            std::cout << RED << "Error: " << args[1] << " is not a valid number of checkpoints." << WHITE << std::endl;
+            return;
+        }
+        if (n == 0) {
+            std::cout << RED << "Error: the number of checkpoints to roll back must be at least 1." << WHITE << std::endl;
+            return;
+        }
+    }
+    unsigned checkpoints = network.getCheckpoints();
+    if (!network.rollback(n)) {
+        std::cout << RED << "Error: there " << (checkpoints == 1 ? "is " : "are ") << checkpoints
+                  << (checkpoints == 1 ? " checkpoint." : " checkpoints.") << WHITE << std::endl;
+        return;
+    }
+    std::cout << "Rolled back to checkpoint " << GREEN << checkpoints - n + 1 << WHITE << "." << std::endl;
+}
+
+void Runtime::showDependency(std::vector<std::string> args) {
     if (args.size() != 2) {
         std::cout << RED << "Error: expected 1 argument." << ANSI_RESET << std::endl;
         return;
@@ -437,7 +690,8 @@ void Runtime::showDependency(std::vector<std::string> args) {
         return;
     }
 
-    if (v->getDependency().empty()) {
+    const std::vector<std::pair<Edge *, Capacity>> &dependency = network.getDependency(v); // calculated now if the flow changed
+    if (dependency.empty()) {
         std::cout << GREEN << "The City of " << v->getCity() << " with id " << id << " does not depend on any Pipeline."
                   << WHITE << std::endl << std::endl;
         return;
@@ -445,10 +699,690 @@ void Runtime::showDependency(std::vector<std::string> args) {
 
     std::cout << YELLOW << "The City of " << v->getCity() << " with id " << id << " depends on these Pipelines:"
               << WHITE << std::endl;
-    for (auto d: v->getDependency()) {
+    for (auto d: dependency) {
         std::cout << d.first->getOrig()->getCode() << " --> " << d.first->getDest()->getCode() << ":" << std::endl
                   << "     Flow before removal of Pipe: " << v->getAdj()[0]->getFlow() << std::endl
                   << "     Flow after removal of Pipe: " << v->getAdj()[0]->getFlow() - d.second << std::endl
                   << "     Difference: " << d.second << std::endl << std::endl;
     }
 }
+
+void Runtime::algorithm(std::vector<std::string> args) {
+    if (args.size() > 2) {
+        std::cout << RED << "Error: expected at most 1 argument." << ANSI_RESET << std::endl;
+        return;
+    }
+
+    if (args.size() == 2) {
+        max_flow_algorithm algorithm;
+        if (!Graph::parseAlgorithm(args[1], algorithm)) {
+            std::cout << RED << "Error: " << args[1] << " is not a valid algorithm." << WHITE << std::endl;
+            return;
+        }
+        network.setAlgorithm(algorithm);
+    }
+    std::cout << "Maximum flow algorithm: " << GREEN << Graph::algorithmName(network.getAlgorithm()) << WHITE << std::endl;
+}
+
+void Runtime::kFailures(std::vector<std::string> args) {
+    if (args.size() != 2 && args.size() != 3) {
+        std::cout << RED << "Error: expected 1 or 2 arguments." << ANSI_RESET << std::endl;
+        return;
+    }
+
+    unsigned k, top = 5;
+    try {
+        k = stoul(args[1]);
+        if (args.size() == 3) top = stoul(args[2]);
+    } catch (...) {
+        std::cout << RED << "Error: expected numbers." << WHITE << std::endl;
+        return;
+    }
+    if (k < 1 || k > 3) {
+        std::cout << RED << "Error: k must be between 1 and 3." << WHITE << std::endl;
+        return;
+    }
+
+    FailureReport report = network.kFailures(k, top);
+    auto describe = [&](unsigned point) {
+        const FailurePoint &p = report.points[point];
+        if (p.station != nullptr) return p.station->getCode();
+        return p.pipe->getOrig()->getCode() + " --> " + p.pipe->getDest()->getCode();
+    };
+
+    std::vector<Vertex *> cities;
+    for (auto city: network.getCityVertexes()) cities.push_back(city.second);
+    std::sort(cities.begin(), cities.end(), [] (Vertex * c1, Vertex * c2) {return c1->getTypeId() < c2->getTypeId();});
+    for (Vertex *city: cities) {
+        const std::vector<FailureScenario> &ranking = report.ranking[city];
+        if (ranking.empty()) continue;
+        std::cout << "  " << std::setw(2) << city->getTypeId() << ": " << city->getCity() << std::endl;
+        for (unsigned i = 0; i < ranking.size(); i++) {
+            std::cout << "     " << i + 1 << ". ";
+            for (unsigned m = 0; m < ranking[i].members.size(); m++)
+                std::cout << (m ? " + " : "") << describe(ranking[i].members[m]);
+            std::cout << ": " << RED << ranking[i].deficit << WHITE << " missing" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Failure points: " << report.points.size() << std::endl
+              << "Combinations evaluated: " << CYAN << report.evaluated << WHITE << std::endl
+              << "Combinations skipped (last failure carried no flow): " << report.skipped << std::endl;
+}
+
+void Runtime::simulate(std::vector<std::string> args) {
+    if (args.size() < 3 || args.size() > 5) {
+        std::cout << RED << "Error: expected 2 to 4 arguments." << ANSI_RESET << std::endl;
+        return;
+    }
+
+    unsigned samples;
+    double probability, percentile = 0.95;
+    unsigned long seed = 1;
+    try {
+        samples = stoul(args[1]);
+        probability = stod(args[2]);
+        if (args.size() > 3) percentile = stod(args[3]);
+        if (args.size() > 4) seed = stoul(args[4]);
+    } catch (...) {
+        std::cout << RED << "Error: expected numbers." << WHITE << std::endl;
+        return;
+    }
+    if (samples == 0 || probability < 0 || probability > 1 || percentile < 0 || percentile > 1) {
+        std::cout << RED << "Error: the probability and the percentile must be between 0 and 1, and there must be samples." << WHITE << std::endl;
+        return;
+    }
+
+    ReliabilityReport report = network.simulateFailures(samples, probability, percentile, seed);
+    std::vector<Vertex *> cities;
+    for (auto city: network.getCityVertexes()) cities.push_back(city.second);
+    std::sort(cities.begin(), cities.end(), [] (Vertex * c1, Vertex * c2) {return c1->getTypeId() < c2->getTypeId();});
+    std::cout << YELLOW << "Water missing with each Pipe failing with probability " << probability << " ("
+              << samples << " samples, seed " << seed << "):" << WHITE << std::endl;
+    for (Vertex *city: cities) {
+        std::cout << "  " << std::setw(2) << city->getTypeId() << ": " << city->getCity() << std::endl
+                  << "     Expected: " << RED << report.expected[city] << WHITE << std::endl
+                  << "     Percentile " << percentile * 100 << ": " << RED << report.percentile[city] << WHITE << std::endl;
+    }
+    std::cout << GREEN << "  In Total:" << WHITE << std::endl
+              << "     Expected: " << RED << report.expectedTotal << WHITE << std::endl
+              << "     Percentile " << percentile * 100 << ": " << RED << report.percentileTotal << WHITE << std::endl
+              << "     Pipes failed per sample: " << CYAN << report.failedPipes << WHITE << std::endl;
+}
+
+void Runtime::estimate(std::vector<std::string> args) {
+    if (args.size() != 2 && args.size() != 3) {
+        std::cout << RED << "Error: expected 1 or 2 arguments." << ANSI_RESET << std::endl;
+        return;
+    }
+
+    std::vector<Vertex *> vertexes;
+    for (unsigned i = 1; i < args.size(); i++) {
+        Vertex *v = network.findVertex(args[i]);
+        if (v == nullptr) {
+            std::cout << RED << "Error: \"" << args[i] << "\" not found." << ANSI_RESET << std::endl;
+            return;
+        }
+        vertexes.push_back(v);
+    }
+
+    FailureEstimate estimate;
+    if (vertexes.size() == 1) {
+        estimate = network.estimateFailure(vertexes[0]);
+    } else {
+        Edge *e = network.findEdge(vertexes[0], vertexes[1]);
+        if (e == nullptr) {
+            std::cout << RED << "Error: The Pipe does not exist." << WHITE << std::endl;
+            return;
+        }
+        estimate = network.estimateFailure(e);
+    }
+
+    std::vector<Vertex *> cities;
+    for (auto p: estimate.deficit) cities.push_back(p.first);
+    std::sort(cities.begin(), cities.end(), [] (Vertex * c1, Vertex * c2) {return c1->getTypeId() < c2->getTypeId();});
+    if (cities.empty()) {
+        std::cout << GREEN << "No water currently flows through " << args[1] << (args.size() == 3 ? " --> " + args[2] : "")
+                  << ", so no City would be affected." << WHITE << std::endl;
+        return;
+    }
+    std::cout << YELLOW << "Cities whose water goes through it:" << WHITE << std::endl;
+    for (Vertex *city: cities) {
+        std::cout << "  " << std::setw(2) << city->getTypeId() << ": " << city->getCity() << std::endl
+                  << "     Water reaching: " << city->getAdj()[0]->getFlow() << std::endl
+                  << "     Missing without rerouting: " << RED << estimate.deficit[city] << WHITE << std::endl;
+    }
+    std::cout << GREEN << "  In Total:" << WHITE << std::endl
+              << "     Missing at most: " << RED << estimate.total << WHITE << std::endl
+              << "     Flow paths cut: " << CYAN << estimate.paths << WHITE << std::endl;
+}
+
+void Runtime::bottlenecks(std::vector<std::string> args) {
+    if (args.size() != 1) {
+        std::cout << RED << "Error: expected no arguments." << ANSI_RESET << std::endl;
+        return;
+    }
+
+    std::vector<Bottleneck> groups = network.bottlenecks();
+    if (groups.empty()) {
+        std::cout << GREEN << "Every City gets all the water it asks for, the demand is the only limit." << WHITE << std::endl;
+        return;
+    }
+    for (unsigned i = 0; i < groups.size(); i++) {
+        const Bottleneck &b = groups[i];
+        std::cout << YELLOW << "Bottleneck " << i + 1 << ":" << WHITE << std::endl
+                  << "  Cities missing water:" << std::endl;
+        for (Vertex *city: b.cities)
+            std::cout << "    " << std::setw(2) << city->getTypeId() << ": " << city->getCity() << ", missing "
+                      << RED << city->getDemand() - city->getAdj()[0]->getFlow() << WHITE << std::endl;
+        if (b.pipes.empty()) {
+            std::cout << "  No Pipe reaches them." << std::endl;
+        } else {
+            std::cout << "  Saturated Pipes into them:" << std::endl;
+            for (Edge *e: b.pipes) {
+                if (e->getOrig() == network.getSource())
+                    std::cout << "    " << e->getDest()->getCode() << " at its max delivery: " << e->getWeight() << std::endl;
+                else
+                    std::cout << "    " << e->getOrig()->getCode() << " --> " << e->getDest()->getCode() << ": " << e->getWeight() << std::endl;
+            }
+        }
+        std::cout << "  Capacity of the cut: " << CYAN << b.capacity << WHITE << std::endl
+                  << "  Missing in total: " << RED << b.missing << WHITE << std::endl << std::endl;
+    }
+}
+
+void Runtime::balance(std::vector<std::string> args) {
+    if (args.size() != 1) {
+        std::cout << RED << "Error: expected no arguments." << ANSI_RESET << std::endl;
+        return;
+    }
+
+    std::cout << YELLOW << "Before balancing:" << WHITE << std::endl;
+    print_pipes_statistics(network);
+    BalanceReport report = network.balanceFlow();
+    std::cout << YELLOW << "After balancing:" << WHITE << std::endl;
+    print_pipes_statistics(network);
+    std::cout << "Utilization cost (flow² / capacity): " << report.costBefore << " --> " << GREEN << report.costAfter << WHITE << std::endl
+              << "Augmentations: " << CYAN << report.augmentations << WHITE << std::endl;
+}
+
+bool Runtime::parseUpgrade(const std::vector<std::string> &args, Upgrade &upgrade) {
+    bool reservoir = !args.empty() && args[0] == "add_reservoir";
+    if (args.empty() || (args[0] != "upgrade_pipe" && args[0] != "add_pipe" && !reservoir)) {
+        std::cout << RED << "Error: " << (args.empty() ? "" : args[0]) << " is not an upgrade." << ANSI_RESET << std::endl;
+        return false;
+    }
+    if (args.size() != (reservoir ? 5 : 4)) {
+        std::cout << RED << "Error: expected " << (reservoir ? 4 : 3) << " arguments." << ANSI_RESET << std::endl;
+        return false;
+    }
+
+    auto toCapacity = [](const std::string &text) {
+        double value = stod(text);
+        return std::is_integral<Capacity>::value ? (Capacity) std::llround(value) : (Capacity) value;
+    };
+    upgrade = Upgrade();
+    upgrade.type = reservoir ? ADD_RESERVOIR : args[0] == "add_pipe" ? ADD_PIPE : UPGRADE_PIPE;
+    try {
+        upgrade.capacity = toCapacity(args.back());
+        if (reservoir) upgrade.delivery = toCapacity(args[2]);
+    } catch (...) {
+        std::cout << RED << "Error: expected numbers." << WHITE << std::endl;
+        return false;
+    }
+    if (upgrade.capacity < 0 || upgrade.delivery < 0) {
+        std::cout << RED << "Error: capacities cannot be negative." << WHITE << std::endl;
+        return false;
+    }
+
+    if (reservoir) {
+        const std::string &code = args[1];
+        if (code.size() < 3 || code.compare(0, 2, "R_") != 0 || code.size() > 11 ||
+            !std::all_of(code.begin() + 2, code.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            std::cout << RED << "Error: " << code << " is not a valid Reservoir code." << WHITE << std::endl;
+            return false;
+        }
+        upgrade.reservoir = stoul(code.substr(2));
+    } else {
+        upgrade.orig = network.findVertex(args[1]);
+        if (upgrade.orig == nullptr) {
+            std::cout << RED << "Error: \"" << args[1] << "\" not found." << ANSI_RESET << std::endl;
+            return false;
+        }
+    }
+    const std::string &destination = args[reservoir ? 3 : 2];
+    upgrade.dest = network.findVertex(destination);
+    if (upgrade.dest == nullptr) {
+        std::cout << RED << "Error: \"" << destination << "\" not found." << ANSI_RESET << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Runtime::printGains(const std::unordered_map<Vertex *, Capacity> &gain, Capacity total) {
+    std::vector<Vertex *> cities;
+    for (auto p: gain) cities.push_back(p.first);
+    std::sort(cities.begin(), cities.end(), [] (Vertex * c1, Vertex * c2) {return c1->getTypeId() < c2->getTypeId();});
+    if (cities.empty()) {
+        std::cout << YELLOW << "No City gets more water." << WHITE << std::endl;
+    } else {
+        std::cout << YELLOW << "Cities that get more water:" << WHITE << std::endl;
+        for (Vertex *city: cities) {
+            std::cout << "  " << std::setw(2) << city->getTypeId() << ": " << city->getCity() << std::endl
+                      << "     Demand: " << YELLOW << city->getDemand() << WHITE << std::endl
+                      << "     Gain: " << GREEN << gain.at(city) << WHITE << std::endl;
+        }
+    }
+    std::cout << GREEN << "  In Total:" << WHITE << std::endl
+              << "     Gain: " << GREEN << total << WHITE << std::endl;
+}
+
+void Runtime::upgrade(const std::vector<std::string> &args) {
+    Upgrade upgrade;
+    if (!parseUpgrade(args, upgrade)) return;
+
+    std::unordered_map<Vertex *, Capacity> before;
+    for (auto c: network.getCityVertexes()) before[c.second] = c.second->getAdj()[0]->getFlow();
+    Capacity flow = network.getFlow();
+    if (!network.applyUpgrade(upgrade)) {
+        switch (upgrade.type) {
+            case UPGRADE_PIPE:
+                std::cout << RED << "Error: The Pipe does not exist, or its capacity is already higher." << WHITE << std::endl;
+                break;
+            case ADD_PIPE:
+                std::cout << RED << "Error: The Pipe already exists, or goes from a location to itself." << WHITE << std::endl;
+                break;
+            case ADD_RESERVOIR:
+                std::cout << RED << "Error: " << args[1] << " already exists." << WHITE << std::endl;
+                break;
+        }
+        return;
+    }
+    network.maxFlow(); // starts from the current flow, so only the new capacity is augmented through
+
+    std::unordered_map<Vertex *, Capacity> gain;
+    for (const std::pair<Vertex * const, Capacity> &c: before) {
+        Capacity difference = c.first->getAdj()[0]->getFlow() - c.second;
+        if (difference > 0) gain[c.first] = difference;
+    }
+    printGains(gain, network.getFlow() - flow);
+}
+
+void Runtime::evaluateUpgrades(std::vector<std::string> args) {
+    if (args.size() != 2) {
+        std::cout << RED << "Error: expected 1 argument." << ANSI_RESET << std::endl;
+        return;
+    }
+    std::ifstream file(args[1]);
+    if (!file.is_open()) {
+        std::cout << RED << "Error: " << args[1] << " could not be opened." << WHITE << std::endl;
+        return;
+    }
+
+    std::vector<Upgrade> candidates;
+    std::vector<std::string> lines;
+    std::string line;
+    for (unsigned number = 1; getline(file, line); number++) {
+        std::istringstream iss(line);
+        std::vector<std::string> command;
+        std::string arg;
+        while (iss >> arg) command.push_back(arg);
+        if (command.empty() || command[0][0] == '#') continue;
+        Upgrade upgrade;
+        if (!parseUpgrade(command, upgrade)) {
+            std::cout << "  (line " << number << " skipped)" << std::endl;
+            continue;
+        }
+        candidates.push_back(upgrade);
+        lines.push_back(line);
+    }
+
+    std::vector<UpgradeReport> reports = network.evaluateUpgrades(candidates);
+    std::vector<unsigned> order(candidates.size());
+    for (unsigned i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&reports](unsigned a, unsigned b) {
+        if (reports[a].applied != reports[b].applied) return reports[a].applied;
+        return reports[a].total > reports[b].total;
+    });
+
+    std::cout << YELLOW << "Upgrades ranked by the water gained (" << candidates.size() << " evaluated):" << WHITE << std::endl;
+    for (unsigned rank = 0; rank < order.size(); rank++) {
+        const UpgradeReport &report = reports[order[rank]];
+        std::cout << "  " << std::setw(2) << rank + 1 << ". " << lines[order[rank]] << std::endl;
+        if (!report.applied) {
+            std::cout << "     " << RED << "Cannot be made." << WHITE << std::endl;
+            continue;
+        }
+        std::cout << "     Gain: " << GREEN << report.total << WHITE << std::endl;
+        std::vector<Vertex *> cities;
+        for (auto p: report.gain) cities.push_back(p.first);
+        std::sort(cities.begin(), cities.end(), [] (Vertex * c1, Vertex * c2) {return c1->getTypeId() < c2->getTypeId();});
+        for (Vertex *city: cities)
+            std::cout << "       " << city->getCode() << " (" << city->getCity() << "): +" << report.gain.at(city) << std::endl;
+    }
+}
+
+void Runtime::stats(std::vector<std::string> args) {
+    if (args.size() == 2 && args[1] == "reset") {
+        Stats::reset();
+        std::cout << "The statistics were reset." << std::endl;
+        return;
+    }
+    if (args.size() == 3 && args[1] == "json") {
+        std::ofstream file(args[2]);
+        if (!file.is_open()) {
+            std::cout << RED << "Error: " << args[2] << " could not be opened." << WHITE << std::endl;
+            return;
+        }
+        std::ostringstream fields;
+        Stats::writeJson(fields);
+        file << '{' << fields.str().substr(1) << "}\n"; // without the comma before the first field
+        std::cout << "The statistics were written to " << GREEN << args[2] << WHITE << std::endl;
+        return;
+    }
+    if (args.size() != 1) {
+        std::cout << RED << "Error: expected no arguments, reset or json <file>." << ANSI_RESET << std::endl;
+        return;
+    }
+    Stats::print(std::cout);
+}
+
+bool Runtime::parseRemoval(const std::vector<std::string> &args, const std::vector<FailurePoint> &removed, FailurePoint &point, std::string &error) const {
+    if (args.size() != (args[0] == "remove" ? 2u : 3u)) {
+        error = args[0] == "remove" ? "expected 1 argument." : "expected 2 arguments.";
+        return false;
+    }
+    std::vector<Vertex *> vertexes;
+    for (unsigned i = 1; i < args.size(); i++) {
+        Vertex *v = network.findVertex(args[i]);
+        for (const FailurePoint &p: removed)
+            if (p.station == v) v = nullptr;
+        if (v == nullptr) {
+            error = "\"" + args[i] + "\" not found.";
+            return false;
+        }
+        vertexes.push_back(v);
+    }
+    if (vertexes.size() == 1) {
+        point = {nullptr, vertexes[0]};
+        return true;
+    }
+    Edge *e = network.findEdge(vertexes[0], vertexes[1]);
+    for (const FailurePoint &p: removed)
+        if (p.pipe == e) e = nullptr;
+    if (e == nullptr) {
+        error = "The Pipe does not exist.";
+        return false;
+    }
+    point = {e, nullptr};
+    return true;
+}
+
+void Runtime::writeRemoval(std::ostream &fields, const RemovalReport &report, bool changes) const {
+    fields << ",\"flow\":" << report.flow;
+    if (!changes) return;
+    fields << ",\"cities\":[";
+    for (unsigned i = 0; i < report.cities.size(); i++) {
+        Vertex *city = report.cities[i].first;
+        fields << (i ? "," : "") << "{\"id\":" << city->getTypeId() << ",\"code\":";
+        writeJson(fields, city->getCode());
+        fields << ",\"before\":" << city->getAdj()[0]->getFlow() << ",\"after\":" << report.cities[i].second << '}';
+    }
+    fields << "],\"reservoirs\":[";
+    for (unsigned i = 0; i < report.reservoirs.size(); i++) {
+        Vertex *reservoir = report.reservoirs[i].first;
+        fields << (i ? "," : "") << "{\"id\":" << reservoir->getTypeId() << ",\"code\":";
+        writeJson(fields, reservoir->getCode());
+        fields << ",\"before\":" << reservoir->getIncoming()[0]->getFlow() << ",\"after\":" << report.reservoirs[i].second << '}';
+    }
+    fields << ']';
+}
+
+bool Runtime::batchQuery(const std::vector<std::string> &args, std::ostream &fields, std::string &error) {
+    const std::string &name = args[0];
+    if (name == "algorithm") {
+        if (args.size() > 2) {
+            error = "expected at most 1 argument.";
+            return false;
+        }
+        if (args.size() == 2) {
+            max_flow_algorithm algorithm;
+            if (!Graph::parseAlgorithm(args[1], algorithm)) {
+                error = args[1] + " is not a valid algorithm.";
+                return false;
+            }
+            network.setAlgorithm(algorithm);
+        }
+        fields << ",\"algorithm\":";
+        writeJson(fields, Graph::algorithmName(network.getAlgorithm()));
+        return true;
+    }
+    if (name == "bottlenecks") {
+        if (args.size() != 1) {
+            error = "expected no arguments.";
+            return false;
+        }
+        std::vector<Bottleneck> groups = network.bottlenecks();
+        fields << ",\"bottlenecks\":[";
+        for (unsigned i = 0; i < groups.size(); i++) {
+            fields << (i ? "," : "") << "{\"cities\":[";
+            for (unsigned j = 0; j < groups[i].cities.size(); j++) {
+                fields << (j ? "," : "");
+                writeJson(fields, groups[i].cities[j]->getCode());
+            }
+            fields << "],\"pipes\":[";
+            for (unsigned j = 0; j < groups[i].pipes.size(); j++) {
+                Edge *e = groups[i].pipes[j];
+                fields << (j ? "," : "") << "{\"orig\":";
+                if (e->getOrig() == network.getSource()) fields << "null";
+                else writeJson(fields, e->getOrig()->getCode());
+                fields << ",\"dest\":";
+                writeJson(fields, e->getDest()->getCode());
+                fields << ",\"capacity\":" << e->getWeight() << '}';
+            }
+            fields << "],\"capacity\":" << groups[i].capacity << ",\"missing\":" << groups[i].missing << '}';
+        }
+        fields << ']';
+        return true;
+    }
+    if (name == "show_dependency" && args.size() == 2) { // query() only reads the cached vectors
+        try {
+            network.getDependency(network.getCityVertexes().at(std::stoul(args[1])));
+        } catch (...) {} // query() writes the error
+    }
+    return query(args, fields, error);
+}
+
+bool Runtime::query(const std::vector<std::string> &args, std::ostream &fields, std::string &error) const {
+    const std::string &name = args[0];
+    auto expect = [&](unsigned low, unsigned high, const std::string &message) {
+        if (args.size() - 1 >= low && args.size() - 1 <= high) return true;
+        error = message;
+        return false;
+    };
+    auto code = [&fields](Vertex *v) {
+        fields << "{\"id\":" << v->getTypeId() << ",\"code\":";
+        writeJson(fields, v->getCode());
+    };
+    auto byTypeId = [](const std::unordered_map<unsigned int, Vertex *> &vertexes) {
+        std::vector<Vertex *> sorted;
+        for (auto p: vertexes) sorted.push_back(p.second);
+        std::sort(sorted.begin(), sorted.end(), [] (Vertex * v1, Vertex * v2) {return v1->getTypeId() < v2->getTypeId();});
+        return sorted;
+    };
+    // the vertexes of the display commands: all of them with -all, or the one with that ID
+    auto select = [&](const std::unordered_map<unsigned int, Vertex *> &vertexes, std::vector<Vertex *> &selected) {
+        if (!expect(1, 1, "expected 1 argument.")) return false;
+        if (args[1] == "-all") {
+            selected = byTypeId(vertexes);
+            return true;
+        }
+        try {
+            selected = {vertexes.at(std::stoul(args[1]))};
+            return true;
+        } catch (...) {
+            error = args[1] + " is not a valid id.";
+            return false;
+        }
+    };
+
+    std::vector<Vertex *> selected;
+    if (name == "display_city") {
+        if (!select(network.getCityVertexes(), selected)) return false;
+        fields << ",\"cities\":[";
+        for (unsigned i = 0; i < selected.size(); i++) {
+            fields << (i ? "," : "");
+            code(selected[i]);
+            fields << ",\"name\":";
+            writeJson(fields, selected[i]->getCity());
+            fields << ",\"demand\":" << selected[i]->getAdj()[0]->getWeight() << ",\"flow\":" << selected[i]->getAdj()[0]->getFlow()
+                   << ",\"population\":" << selected[i]->getPopulation() << '}';
+        }
+        fields << ']';
+    } else if (name == "display_reservoir") {
+        if (!select(network.getReservoirVertexes(), selected)) return false;
+        fields << ",\"reservoirs\":[";
+        for (unsigned i = 0; i < selected.size(); i++) {
+            fields << (i ? "," : "");
+            code(selected[i]);
+            fields << ",\"name\":";
+            writeJson(fields, selected[i]->getReservoir());
+            fields << ",\"municipality\":";
+            writeJson(fields, selected[i]->getMunicipality());
+            fields << ",\"max_delivery\":" << selected[i]->getIncoming()[0]->getWeight() << ",\"flow\":" << selected[i]->getIncoming()[0]->getFlow() << '}';
+        }
+        fields << ']';
+    } else if (name == "display_station") {
+        if (!select(network.getStationVertexes(), selected)) return false;
+        fields << ",\"stations\":[";
+        for (unsigned i = 0; i < selected.size(); i++) {
+            Capacity passing = 0;
+            for (Edge *e: selected[i]->getIncoming()) passing += e->getFlow();
+            fields << (i ? "," : "");
+            code(selected[i]);
+            fields << ",\"flow\":" << passing << '}';
+        }
+        fields << ']';
+    } else if (name == "needy_cities") {
+        if (!expect(0, 0, "expected no arguments.")) return false;
+        Capacity missing = 0;
+        bool first = true;
+        fields << ",\"cities\":[";
+        for (Vertex *city: byTypeId(network.getCityVertexes())) {
+            Capacity reaching = city->getAdj()[0]->getFlow();
+            if (!(city->getDemand() > reaching)) continue;
+            fields << (first ? "" : ",");
+            first = false;
+            code(city);
+            fields << ",\"demand\":" << city->getDemand() << ",\"flow\":" << reaching << ",\"missing\":" << city->getDemand() - reaching << '}';
+            missing += city->getDemand() - reaching;
+        }
+        fields << "],\"missing\":" << missing;
+    } else if (name == "show_dependency") {
+        if (!expect(1, 1, "expected 1 argument.")) return false;
+        Vertex *city;
+        try {
+            city = network.getCityVertexes().at(std::stoul(args[1]));
+        } catch (...) {
+            error = args[1] + " is not a valid City id.";
+            return false;
+        }
+        if (!network.isDependencyKnown(city)) {
+            error = "the dependencies of the City are not calculated for the current flow.";
+            return false;
+        }
+        fields << ",\"flow\":" << city->getAdj()[0]->getFlow() << ",\"pipes\":[";
+        for (unsigned i = 0; i < city->getDependency().size(); i++) {
+            const std::pair<Edge *, Capacity> &d = city->getDependency()[i];
+            fields << (i ? "," : "") << "{\"orig\":";
+            writeJson(fields, d.first->getOrig()->getCode());
+            fields << ",\"dest\":";
+            writeJson(fields, d.first->getDest()->getCode());
+            fields << ",\"difference\":" << d.second << '}';
+        }
+        fields << ']';
+    } else if (name == "estimate") {
+        if (!expect(1, 2, "expected 1 or 2 arguments.")) return false;
+        std::vector<Vertex *> vertexes;
+        for (unsigned i = 1; i < args.size(); i++) {
+            vertexes.push_back(network.findVertex(args[i]));
+            if (vertexes.back() == nullptr) {
+                error = "\"" + args[i] + "\" not found.";
+                return false;
+            }
+        }
+        FailureEstimate estimate;
+        if (vertexes.size() == 1) {
+            estimate = network.estimateFailure(vertexes[0]);
+        } else {
+            Edge *e = network.findEdge(vertexes[0], vertexes[1]);
+            if (e == nullptr) {
+                error = "The Pipe does not exist.";
+                return false;
+            }
+            estimate = network.estimateFailure(e);
+        }
+        std::vector<Vertex *> cities;
+        for (auto p: estimate.deficit) cities.push_back(p.first);
+        std::sort(cities.begin(), cities.end(), [] (Vertex * c1, Vertex * c2) {return c1->getTypeId() < c2->getTypeId();});
+        fields << ",\"cities\":[";
+        for (unsigned i = 0; i < cities.size(); i++) {
+            fields << (i ? "," : "");
+            code(cities[i]);
+            fields << ",\"flow\":" << cities[i]->getAdj()[0]->getFlow() << ",\"missing\":" << estimate.deficit[cities[i]] << '}';
+        }
+        fields << "],\"missing\":" << estimate.total << ",\"paths\":" << estimate.paths;
+    } else if (name == "stats") {
+        if (!expect(0, 0, "expected no arguments.")) return false;
+        Stats::writeJson(fields);
+    } else if (name == "pipes_statistics") {
+        if (!expect(0, 0, "expected no arguments.")) return false;
+        PipeStatistics statistics = pipes_statistics(network);
+        fields << ",\"pipes\":" << statistics.pipes << ",\"mean\":" << statistics.mean << ",\"variance\":" << statistics.variance
+               << ",\"standard_deviation\":" << statistics.standard_deviation << ",\"median\":" << statistics.median
+               << ",\"q1\":" << statistics.q1 << ",\"q3\":" << statistics.q3 << ",\"aqi\":" << statistics.aqi
+               << ",\"maximum_amplitude\":" << statistics.maximum_amplitude << ",\"empty\":" << statistics.empty << ",\"full\":" << statistics.full;
+    } else {
+        error = "\"" + name + "\" is not available in this mode.";
+        return false;
+    }
+    return true;
+}
+
+void Runtime::prepareQueries() {
+    network.getPathIndex(); // also brings the arrays up to date
+    for (auto p: network.getCityVertexes()) {
+        if (!network.isDependencyKnown(p.second)) {
+            network.calculateDependency();
+            break;
+        }
+    }
+}
+
+std::string Runtime::respond(unsigned line, const std::vector<std::string> &command) const {
+    std::ostringstream out, fields;
+    out.precision(15);
+    fields.precision(15);
+    out << "{\"line\":" << line << ",\"command\":";
+    writeJson(out, command[0]);
+    PhaseTimer timer("command", command[0]);
+    std::string error;
+    bool ok;
+    if (command[0] == "remove" || command[0] == "remove_pipe") { // on a copy of the flow, so the network stays the same for the other queries
+        FailurePoint point{nullptr, nullptr};
+        ok = parseRemoval(command, {}, point, error);
+        if (ok)
+            writeRemoval(fields, network.evaluateRemovals({{point}})[0], true);
+    } else {
+        ok = query(command, fields, error);
+    }
+    if (ok) {
+        out << ",\"ok\":true" << fields.str();
+    } else {
+        timer.discard();
+        out << ",\"ok\":false,\"error\":";
+        writeJson(out, error);
+    }
+    out << "}\n";
+    return out.str();
+}
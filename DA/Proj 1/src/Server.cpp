@@ -0,0 +1,190 @@
+/**
+ * @file Server.cpp
+ * @brief Definition of class Server
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/Server.hpp"
+#include "../lib/Parallel.hpp"
+#include <climits>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+//! Pipe written by the signal handler; the workers poll its read end, so all of them wake up when the server stops
+static int stopPipe[2] = {-1, -1};
+
+//! Longest line accepted from a client, so that a client without new lines cannot take all the memory
+static const size_t MAX_LINE = 1 << 20;
+
+/**
+ * @brief Makes the workers stop
+ * @param int: signal
+ * @return void
+ * @note This function is static
+ * @note Time Complexity: O(1), Space Complexity: O(1)
+ */
+static void stopServer(int) {
+    char c = 0;
+    if (write(stopPipe[1], &c, 1) < 0) {} // only async-signal-safe calls here; a full pipe already wakes the workers
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+Server::Server(const Runtime &runtime, const std::string &path, unsigned threads)
+        : runtime(runtime), path(path), threads(threads) {}
+
+//! Time Complexity: the one of the requests served, Space Complexity: O(threads)
+bool Server::run() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, path.c_str());
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        unlink(path.c_str()); // left behind by a server that did not stop cleanly
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        return false;
+    if (bind(listener, (sockaddr *) &address, sizeof(address)) < 0) {
+        close(listener);
+        return false;
+    }
+    if (listen(listener, SOMAXCONN) < 0 || fcntl(listener, F_SETFL, fcntl(listener, F_GETFL) | O_NONBLOCK) < 0 || pipe(stopPipe) < 0) {
+        close(listener);
+        unlink(path.c_str()); // bind() created the socket file
+        return false;
+    }
+
+    struct sigaction action{};
+    action.sa_handler = stopServer;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < workerCount(UINT_MAX, threads); i++)
+        workers.emplace_back(&Server::work, this);
+    for (std::thread &t: workers)
+        t.join();
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    close(listener);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+    unlink(path.c_str());
+    return true;
+}
+
+//! Time Complexity: the one of the requests served, plus O(c) per wake-up, Space Complexity: O(c)
+void Server::work() const {
+    std::vector<Connection> clients;
+    std::vector<pollfd> fds;
+    while (true) {
+        fds.assign({{listener, POLLIN, 0}, {stopPipe[0], POLLIN, 0}});
+        for (const Connection &c: clients)
+            fds.push_back({c.socket, (short) (c.output.empty() ? (c.closing ? 0 : POLLIN) : POLLOUT), 0});
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents != 0)
+            break;
+
+        // fds[i + 2] is the one of clients[i]; the clients dropped are swapped with the last one, so they are gone through backwards
+        for (unsigned i = clients.size(); i-- > 0;) {
+            Connection &c = clients[i];
+            short events = fds[i + 2].revents;
+            bool keep = true;
+            if (events & (POLLIN | POLLHUP | POLLERR))
+                keep = c.output.empty() && !c.closing ? receive(c) : !(events & POLLERR);
+            if (keep && !c.output.empty() && (events & (POLLOUT | POLLIN | POLLHUP | POLLERR)))
+                keep = flush(c);
+            if (!keep || (c.closing && c.output.empty())) {
+                close(c.socket);
+                if (i + 1 != clients.size())
+                    c = std::move(clients.back());
+                clients.pop_back();
+            }
+        }
+
+        if (fds[0].revents != 0) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0) // another worker took it
+                continue;
+            if (fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK) < 0) {
+                close(client);
+                continue;
+            }
+            clients.emplace_back();
+            clients.back().socket = client;
+        }
+    }
+    for (const Connection &c: clients)
+        close(c.socket);
+}
+
+//! Time Complexity: the one of the requests, Space Complexity: O(l)
+bool Server::receive(Connection &c) const {
+    // answers one line, false once the client says exit
+    auto handle = [&](const std::string &line) {
+        std::istringstream iss(line);
+        std::vector<std::string> command;
+        std::string arg;
+        while (iss >> arg) command.push_back(arg);
+        c.number++;
+        if (command.empty() || command[0][0] == '#') return true;
+        if (command[0] == "exit") return false;
+        c.output += runtime.respond(c.number, command);
+        return true;
+    };
+
+    char chunk[1 << 16];
+    ssize_t n = recv(c.socket, chunk, sizeof(chunk), 0);
+    if (n < 0)
+        return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+    if (n == 0) { // the client closed its side, and the last line may have no new line
+        c.closing = true;
+        if (!c.pending.empty())
+            handle(c.pending);
+        c.pending.clear();
+        return true;
+    }
+    c.pending.append(chunk, n);
+    size_t start = 0, end;
+    while (!c.closing && (end = c.pending.find('\n', start)) != std::string::npos) {
+        c.closing = !handle(c.pending.substr(start, end - start));
+        start = end + 1;
+    }
+    c.pending.erase(0, start);
+    return c.pending.size() <= MAX_LINE;
+}
+
+//! Time Complexity: O(n), Space Complexity: O(1)
+bool Server::flush(Connection &c) const {
+    size_t sent = 0;
+    while (sent < c.output.size()) {
+        ssize_t n = send(c.socket, c.output.data() + sent, c.output.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break; // the rest waits for POLLOUT
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    c.output.erase(0, sent);
+    return true;
+}
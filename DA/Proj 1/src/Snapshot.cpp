@@ -0,0 +1,243 @@
+/**
+ * @file Snapshot.cpp
+ * @brief Definition of the binary snapshot of a parsed network, its flow and its dependencies
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/Snapshot.hpp"
+#include "../lib/MappedFile.hpp"
+#include "../lib/Stats.hpp"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <unordered_map>
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0 && sizeof(SnapshotVertex) % 8 == 0 &&
+              sizeof(SnapshotEdge) % 8 == 0 && sizeof(SnapshotDependency) % 8 == 0,
+              "the records of a snapshot must keep every section aligned to 8 bytes");
+
+/**
+ * @brief Rounds a size up to a multiple of 8
+ * @param uint64_t size: size
+ * @return uint64_t: aligned size
+ * @note Time Complexity: O(1), Space Complexity: O(1)
+ */
+static uint64_t align8(uint64_t size) {
+    return (size + 7) & ~(uint64_t) 7;
+}
+
+//! Time Complexity: O(n), n being the size of the file, Space Complexity: O(1)
+uint64_t hashFile(const std::string &file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in.good())
+        return 0;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    char buffer[1 << 16];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        for (std::streamsize i = 0; i < in.gcount(); i++) {
+            hash ^= (unsigned char) buffer[i];
+            hash *= 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+bool writeSnapshot(const Graph &network, const std::string &file, const std::vector<uint64_t> &hashes) {
+    if (hashes.size() != 4 || !network.getRemovedVertexes().empty() || !network.getRemovedEdges().empty())
+        return false;
+
+    std::vector<const Vertex *> vertexes = {network.getSource(), network.getSink()};
+    vertexes.insert(vertexes.end(), network.getVertexSet().begin(), network.getVertexSet().end());
+    std::unordered_map<const Vertex *, uint32_t> vertexIndex;
+    for (uint32_t i = 0; i < vertexes.size(); i++)
+        vertexIndex.emplace(vertexes[i], i);
+
+    std::vector<SnapshotVertex> vertexRecords(vertexes.size());
+    std::vector<SnapshotEdge> edgeRecords;
+    std::unordered_map<const Edge *, uint32_t> edgeIndex;
+    std::string strings;
+    for (uint32_t i = 0; i < vertexes.size(); i++) {
+        for (const Edge *e: vertexes[i]->getAdj()) {
+            edgeIndex.emplace(e, edgeRecords.size());
+            edgeRecords.push_back({i, vertexIndex.at(e->getDest()), (double) e->getWeight(), (double) e->getFlow()});
+        }
+    }
+
+    std::vector<uint32_t> incoming;
+    std::vector<SnapshotDependency> dependencies;
+    for (uint32_t i = 0; i < vertexes.size(); i++) {
+        const Vertex *v = vertexes[i];
+        SnapshotVertex &record = vertexRecords[i];
+        std::memset(&record, 0, sizeof(record));
+        record.id = v->getId();
+        record.type = v->getType();
+        record.name = record.municipality = strings.size();
+        if (v->getType() == CITY) { // the getters of the names throw for the other types
+            record.population = v->getPopulation();
+            record.nameLength = v->getCity().size();
+            strings += v->getCity();
+        } else if (v->getType() == RESERVOIR) {
+            record.nameLength = v->getReservoir().size();
+            strings += v->getReservoir();
+            record.municipality = strings.size();
+            record.municipalityLength = v->getMunicipality().size();
+            strings += v->getMunicipality();
+        }
+
+        record.firstIncoming = incoming.size();
+        record.incomingCount = v->getIncoming().size();
+        for (const Edge *e: v->getIncoming())
+            incoming.push_back(edgeIndex.at(e));
+        record.firstDependency = dependencies.size();
+        if (v->getType() == CITY && network.isDependencyKnown(v)) {
+            record.dependencyKnown = 1;
+            record.dependencyCount = v->getDependency().size();
+            for (const std::pair<Edge *, Capacity> &d: v->getDependency())
+                dependencies.push_back({edgeIndex.at(d.first), 0, (double) d.second});
+        }
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    for (unsigned i = 0; i < 4; i++)
+        header.hashes[i] = hashes[i];
+    header.algorithm = network.getAlgorithm();
+    header.vertexes = vertexRecords.size();
+    header.edges = edgeRecords.size();
+    header.dependencies = dependencies.size();
+    header.capacity = SNAPSHOT_CAPACITY;
+    header.stringBytes = strings.size();
+    header.vertexOffset = sizeof(SnapshotHeader);
+    header.edgeOffset = header.vertexOffset + vertexRecords.size() * sizeof(SnapshotVertex);
+    header.incomingOffset = header.edgeOffset + edgeRecords.size() * sizeof(SnapshotEdge);
+    header.dependencyOffset = header.incomingOffset + align8(incoming.size() * sizeof(uint32_t));
+    header.stringOffset = header.dependencyOffset + dependencies.size() * sizeof(SnapshotDependency);
+    header.fileSize = header.stringOffset + strings.size();
+
+    const std::string temporary = file + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        const char zeros[8] = {};
+        out.write((const char *) &header, sizeof(header));
+        out.write((const char *) vertexRecords.data(), vertexRecords.size() * sizeof(SnapshotVertex));
+        out.write((const char *) edgeRecords.data(), edgeRecords.size() * sizeof(SnapshotEdge));
+        out.write((const char *) incoming.data(), incoming.size() * sizeof(uint32_t));
+        out.write(zeros, align8(incoming.size() * sizeof(uint32_t)) - incoming.size() * sizeof(uint32_t));
+        out.write((const char *) dependencies.data(), dependencies.size() * sizeof(SnapshotDependency));
+        out.write(strings.data(), strings.size());
+        if (!out.good()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), file.c_str()) == 0;
+}
+
+/**
+ * @brief Checks every count, offset and index of a mapped snapshot
+ * @param const char* data: start of the file
+ * @param uint64_t size: size of the file
+ * @return bool: true if the records can be read without going out of the file
+ * @note Time Complexity: O(V + E), Space Complexity: O(1)
+ */
+static bool validSnapshot(const char *data, uint64_t size) {
+    const SnapshotHeader &h = *(const SnapshotHeader *) data;
+    if (h.fileSize != size || h.vertexes < 2)
+        return false;
+    if (h.vertexOffset != sizeof(SnapshotHeader) ||
+        h.edgeOffset != h.vertexOffset + (uint64_t) h.vertexes * sizeof(SnapshotVertex) ||
+        h.incomingOffset != h.edgeOffset + (uint64_t) h.edges * sizeof(SnapshotEdge) ||
+        h.dependencyOffset != h.incomingOffset + align8((uint64_t) h.edges * sizeof(uint32_t)) ||
+        h.stringOffset != h.dependencyOffset + (uint64_t) h.dependencies * sizeof(SnapshotDependency) ||
+        h.fileSize != h.stringOffset + h.stringBytes)
+        return false;
+
+    const SnapshotVertex *vertexes = (const SnapshotVertex *) (data + h.vertexOffset);
+    const SnapshotEdge *edges = (const SnapshotEdge *) (data + h.edgeOffset);
+    const uint32_t *incoming = (const uint32_t *) (data + h.incomingOffset);
+    const SnapshotDependency *dependencies = (const SnapshotDependency *) (data + h.dependencyOffset);
+    if (vertexes[0].type != SOURCE || vertexes[1].type != SINK)
+        return false;
+    for (uint32_t i = 0; i < h.vertexes; i++) {
+        const SnapshotVertex &v = vertexes[i];
+        if ((i >= 2 && v.type != CITY && v.type != RESERVOIR && v.type != STATION) ||
+            v.name + v.nameLength > h.stringBytes || v.municipality + v.municipalityLength > h.stringBytes ||
+            (uint64_t) v.firstIncoming + v.incomingCount > h.edges ||
+            (uint64_t) v.firstDependency + v.dependencyCount > h.dependencies || (v.type != CITY && (v.dependencyCount > 0 || v.dependencyKnown)))
+            return false;
+        for (uint32_t j = v.firstIncoming; j < v.firstIncoming + v.incomingCount; j++)
+            if (incoming[j] >= h.edges || edges[incoming[j]].dest != i)
+                return false;
+    }
+    uint32_t previous = 0;
+    for (uint32_t e = 0; e < h.edges; e++) {
+        if (edges[e].orig >= h.vertexes || edges[e].dest >= h.vertexes || edges[e].orig < previous)
+            return false; // the edges must be grouped by origin
+        previous = edges[e].orig;
+    }
+    for (uint32_t d = 0; d < h.dependencies; d++)
+        if (dependencies[d].edge >= h.edges)
+            return false;
+    return true;
+}
+
+//! Time Complexity: O(V + E), Space Complexity: O(V + E)
+bool loadSnapshot(Graph &network, const std::string &file, const std::vector<uint64_t> &hashes) {
+    PhaseTimer timer("load_snapshot");
+    if (hashes.size() != 4)
+        return false;
+    MappedFile mapping(file);
+    if (mapping.size() < sizeof(SnapshotHeader))
+        return false;
+    const uint64_t size = mapping.size();
+    const char *data = mapping.begin();
+    const SnapshotHeader &h = *(const SnapshotHeader *) data;
+
+    bool valid = std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) == 0 && h.version == SNAPSHOT_VERSION &&
+                 h.byteOrder == SNAPSHOT_BYTE_ORDER && h.capacity == SNAPSHOT_CAPACITY && h.algorithm == (uint32_t) network.getAlgorithm();
+    for (unsigned i = 0; i < 4 && valid; i++)
+        valid = h.hashes[i] == hashes[i];
+    if (!valid || !validSnapshot(data, size))
+        return false;
+
+    const SnapshotVertex *vertexRecords = (const SnapshotVertex *) (data + h.vertexOffset);
+    const SnapshotEdge *edgeRecords = (const SnapshotEdge *) (data + h.edgeOffset);
+    const uint32_t *incoming = (const uint32_t *) (data + h.incomingOffset);
+    const SnapshotDependency *dependencies = (const SnapshotDependency *) (data + h.dependencyOffset);
+    const char *strings = data + h.stringOffset;
+
+    std::vector<Vertex *> vertexes = {network.getSource(), network.getSink()};
+    for (uint32_t i = 2; i < h.vertexes; i++) {
+        const SnapshotVertex &r = vertexRecords[i];
+        std::string name(strings + r.name, r.nameLength), municipality(strings + r.municipality, r.municipalityLength);
+        Vertex *v = r.type == CITY ? network.createVertex(CITY, r.id, "", "", name, r.population)
+                                   : network.createVertex((node_type) r.type, r.id, name, municipality);
+        network.addVertex(v);
+        vertexes.push_back(v);
+    }
+
+    std::vector<Edge *> edges(h.edges);
+    std::vector<Vertex *> known;
+    for (uint32_t e = 0; e < h.edges; e++) { // grouped by origin, so each adjacency vector keeps its order
+        Vertex *orig = vertexes[edgeRecords[e].orig];
+        edges[e] = network.createEdge(orig, vertexes[edgeRecords[e].dest], (Capacity) edgeRecords[e].capacity);
+        edges[e]->setFlow((Capacity) edgeRecords[e].flow);
+        orig->getAdj().push_back(edges[e]);
+    }
+    for (uint32_t i = 0; i < h.vertexes; i++) {
+        const SnapshotVertex &r = vertexRecords[i];
+        for (uint32_t j = r.firstIncoming; j < r.firstIncoming + r.incomingCount; j++)
+            vertexes[i]->getIncoming().push_back(edges[incoming[j]]);
+        for (uint32_t d = r.firstDependency; d < r.firstDependency + r.dependencyCount; d++)
+            vertexes[i]->addDependency(edges[dependencies[d].edge], (Capacity) dependencies[d].deficit);
+        if (r.dependencyKnown)
+            known.push_back(vertexes[i]);
+    }
+    network.setDependencyKnown(known);
+    return true;
+}
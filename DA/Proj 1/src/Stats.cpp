@@ -0,0 +1,162 @@
+/**
+ * @file Stats.cpp
+ * @brief Definition of the counters of the solvers and the timers of each phase
+ * @author G17_5
+ * @date 16/10/2026
+ */
+
+#include "../lib/Stats.hpp"
+#include "../lib/Macros.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <mutex>
+
+//! Calls and time of a phase
+struct PhaseTime {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+};
+
+static const char *const COUNTER_NAMES[STAT_COUNTERS] = {"searches", "arcs_scanned", "augmenting_paths", "path_arcs", "allocations"};
+
+#ifndef NO_STATS
+static std::atomic<uint64_t> counters[STAT_COUNTERS];     /*!< Added with relaxed order: they are only read as totals */
+static std::mutex phasesMutex;
+static std::map<std::string, PhaseTime> phases;         /*!< Guarded by phasesMutex */
+#endif
+
+/**
+ * @brief Takes a copy of the counters and phases
+ * @param uint64_t* values: filled with the value of each counter
+ * @return std::map<std::string, PhaseTime>: phases
+ * @note This function is static
+ * @note Time Complexity: O(p), Space Complexity: O(p)
+ */
+static std::map<std::string, PhaseTime> snapshot(uint64_t *values) {
+#ifdef NO_STATS
+    std::fill(values, values + STAT_COUNTERS, 0);
+    return {};
+#else
+    for (unsigned c = 0; c < STAT_COUNTERS; c++)
+        values[c] = counters[c].load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    return phases;
+#endif
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+bool Stats::enabled() {
+#ifdef NO_STATS
+    return false;
+#else
+    return true;
+#endif
+}
+
+#ifndef NO_STATS
+//! Time Complexity: O(1), Space Complexity: O(1)
+void Stats::add(stat_counter counter, uint64_t amount) {
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+uint64_t Stats::get(stat_counter counter) {
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+//! Time Complexity: O(log p), Space Complexity: O(1)
+void Stats::time(const std::string &phase, uint64_t nanoseconds) {
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    PhaseTime &t = phases[phase];
+    t.calls++;
+    t.nanoseconds += nanoseconds;
+}
+#endif
+
+//! Time Complexity: O(p), Space Complexity: O(1)
+void Stats::reset() {
+#ifndef NO_STATS
+    for (std::atomic<uint64_t> &c: counters)
+        c.store(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(phasesMutex);
+    phases.clear();
+#endif
+}
+
+//! Time Complexity: O(p), Space Complexity: O(p)
+void Stats::print(std::ostream &out) {
+    if (!enabled()) {
+        out << RED << "The statistics were compiled out (-DNO_STATS)." << WHITE << '\n';
+        return;
+    }
+    uint64_t values[STAT_COUNTERS];
+    std::map<std::string, PhaseTime> copy = snapshot(values);
+    const char *labels[STAT_COUNTERS] = {"Searches: ", "Arcs scanned: ", "Augmenting paths: ", "Path arcs: ", "Allocations: "};
+    out << MAGENTA << "Solver counters\n";
+    for (unsigned c = 0; c < STAT_COUNTERS; c++)
+        out << YELLOW << std::setw(26) << labels[c] << WHITE << values[c] << '\n';
+    if (values[STAT_SEARCHES] > 0)
+        out << YELLOW << std::setw(26) << "Arcs per search: " << WHITE << (double) values[STAT_ARCS_SCANNED] / values[STAT_SEARCHES] << '\n';
+    if (values[STAT_AUGMENTING_PATHS] > 0)
+        out << YELLOW << std::setw(26) << "Average path length: " << WHITE << (double) values[STAT_PATH_ARCS] / values[STAT_AUGMENTING_PATHS] << '\n';
+
+    out << MAGENTA << "\nWall-clock time per phase\n";
+    out << YELLOW << std::left << std::setw(26) << "Phase" << std::right << std::setw(10) << "Calls" << std::setw(15) << "Total (ms)"
+        << std::setw(15) << "Average (ms)" << WHITE << '\n';
+    for (const std::pair<const std::string, PhaseTime> &p: copy) {
+        double total = p.second.nanoseconds / 1e6;
+        out << std::left << std::setw(26) << p.first << std::right << std::setw(10) << p.second.calls
+            << std::setw(15) << std::fixed << std::setprecision(3) << total
+            << std::setw(15) << total / p.second.calls << std::defaultfloat << std::setprecision(6) << '\n';
+    }
+    out << ANSI_RESET << '\n';
+}
+
+//! Time Complexity: O(p), Space Complexity: O(p)
+void Stats::writeJson(std::ostream &fields) {
+    uint64_t values[STAT_COUNTERS];
+    std::map<std::string, PhaseTime> copy = snapshot(values);
+    fields << ",\"enabled\":" << (enabled() ? "true" : "false") << ",\"counters\":{";
+    for (unsigned c = 0; c < STAT_COUNTERS; c++)
+        fields << (c ? "," : "") << '"' << COUNTER_NAMES[c] << "\":" << values[c];
+    fields << "},\"phases\":{";
+    bool first = true;
+    for (const std::pair<const std::string, PhaseTime> &p: copy) { // the names are the ones of the phases and commands, nothing to escape
+        fields << (first ? "" : ",") << '"' << p.first << "\":{\"calls\":" << p.second.calls
+               << ",\"seconds\":" << p.second.nanoseconds / 1e9 << '}';
+        first = false;
+    }
+    fields << '}';
+}
+
+#ifndef NO_STATS
+//! Time Complexity: O(1), Space Complexity: O(1)
+SolverCounters::~SolverCounters() {
+    if (searches) Stats::add(STAT_SEARCHES, searches);
+    if (arcs) Stats::add(STAT_ARCS_SCANNED, arcs);
+    if (paths) {
+        Stats::add(STAT_AUGMENTING_PATHS, paths);
+        Stats::add(STAT_PATH_ARCS, pathArcs);
+    }
+}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+PhaseTimer::PhaseTimer(const char *phase): phase(phase), name(nullptr), start(std::chrono::steady_clock::now()) {}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+PhaseTimer::PhaseTimer(const char *phase, const std::string &name): phase(phase), name(&name), start(std::chrono::steady_clock::now()) {}
+
+//! Time Complexity: O(1), Space Complexity: O(1)
+void PhaseTimer::discard() {
+    discarded = true;
+}
+
+//! Time Complexity: the one of Stats::time(), Space Complexity: O(1)
+PhaseTimer::~PhaseTimer() {
+    if (discarded) return;
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    Stats::time(name == nullptr ? std::string(phase) : std::string(phase) + ':' + *name, elapsed);
+}
+#endif
@@ -14,7 +14,7 @@ void print_statistics(const Graph &g) {
     double ratio = 0;
     for (Vertex *v: g.getVertexSet()) {
         for (Edge *e: v->getAdj()) {
-            ratio = e->getFlow() / e->getWeight();
+            ratio = (double) e->getFlow() / (double) e->getWeight();
             sorted.push_back(ratio);
             mean += ratio;
             n++;
@@ -27,7 +27,7 @@ void print_statistics(const Graph &g) {
         }
     }
     for (Edge *e: g.getSource()->getAdj()) {
-        ratio = e->getFlow() / e->getWeight();
+        ratio = (double) e->getFlow() / (double) e->getWeight();
         sorted.push_back(ratio);
         mean += ratio;
         n++;
@@ -386,21 +386,482 @@ void test_flow_after_remove(Graph g) {
     }
 }
 
+//! Time Complexity: O(V³ + E * f), Space Complexity: O(V + E)
+void test_max_flow_algorithms(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    g.resetFlow();
+    unsigned iterations = g.edmondsKarp();
+    double expected = g.getFlow();
+    std::cout << "Edmonds-Karp: " << YELLOW << expected << WHITE << " (" << iterations << " BFSes)\n";
+
+    g.resetFlow();
+    double flow = g.fordFulkerson(&iterations);
+    std::cout << "Ford-Fulkerson: " << (flow == expected && g.getFlow() == expected ? GREEN : RED) << g.getFlow()
+              << WHITE << " (" << iterations << " DFSes)\n";
+
+    g.resetFlow();
+    iterations = g.dinic();
+    std::cout << "Dinic: " << (g.getFlow() == expected ? GREEN : RED) << g.getFlow()
+              << WHITE << " (" << iterations << " BFSes)\n";
+
+    g.resetFlow();
+    iterations = g.pushRelabel();
+    std::cout << "Push-Relabel: " << (g.getFlow() == expected && g.getFlowFromSource() == expected ? GREEN : RED)
+              << g.getFlow() << WHITE << " (" << iterations << " global relabellings)\n";
+    unsigned unbalanced = 0, invalid = 0;
+    for (Vertex *v: g.getVertexSet()) {
+        double in = 0, out = 0;
+        for (Edge *e: v->getIncoming()) in += e->getFlow();
+        for (Edge *e: v->getAdj()) {
+            out += e->getFlow();
+            invalid += (e->getFlow() < 0 || e->getFlow() > e->getWeight());
+        }
+        unbalanced += (in != out);
+    }
+    std::cout << (unbalanced == 0 && invalid == 0 ? GREEN : RED) << "Unbalanced vertexes: " << unbalanced
+              << ", invalid edges: " << invalid << '\n';
+    std::cout << ANSI_RESET;
+}
+
+//! Time Complexity: O(P * V + E) plus a maximum flow per checked vertex, Space Complexity: O(V + E)
+void test_path_index(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    const PathIndex &index = g.getPathIndex();
+    const ResidualGraph &r = g.getResidual();
+    std::unordered_map<Vertex *, double> delivered;
+    for (unsigned p = 0; p < index.pathCount(); p++)
+        delivered[g.getVertex(r.getTail(index.getCityArc(p)))] += index.getAmount(p);
+    unsigned wrong = 0;
+    for (auto c: g.getCityVertexes())
+        wrong += delivered[c.second] != c.second->getAdj()[0]->getFlow();
+    std::cout << "Paths: " << index.pathCount() << ", cycles cancelled: " << index.getCycles() << '\n'
+              << (wrong == 0 ? GREEN : RED) << "Cities whose paths do not add up to their flow: " << wrong << WHITE << '\n';
+
+    // the flow lost after a removal never exceeds the estimate, for any algorithm
+    std::vector<Vertex *> stations;
+    for (auto s: g.getStationVertexes()) stations.push_back(s.second);
+    unsigned exceeded = 0;
+    for (Vertex *station: stations) {
+        FailureEstimate estimate = g.estimateFailure(station);
+        double before = g.getFlow();
+        g.checkpoint();
+        g.removeVertex(station);
+        g.maxFlow();
+        exceeded += before - g.getFlow() > estimate.total;
+        g.rollback();
+    }
+    std::cout << (exceeded == 0 ? GREEN : RED) << "Station removals losing more than estimated: " << exceeded
+              << " / " << stations.size() << ANSI_RESET << '\n';
+}
+
+void test_components(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    const Components &components = g.getComponents();
+    unsigned largest = 0;
+    for (unsigned c = 0; c < components.count(); c++)
+        largest = std::max(largest, components.size(c));
+    std::cout << "Components: " << components.count() << ", largest: " << largest << " vertexes\n";
+
+    // re-solving only the component of a removed station reaches the same flow as solving the whole network again
+    std::vector<Vertex *> stations;
+    for (auto s: g.getStationVertexes()) stations.push_back(s.second);
+    unsigned wrong = 0;
+    for (Vertex *station: stations) {
+        g.checkpoint();
+        g.removeVertex(station);
+        g.maxFlow();
+        double local = g.getFlow();
+        g.resetFlow();
+        g.edmondsKarp();
+        wrong += local != g.getFlow();
+        g.rollback();
+    }
+    std::cout << (wrong == 0 ? GREEN : RED) << "Station removals whose local re-solve differs from a full one: " << wrong
+              << " / " << stations.size() << ANSI_RESET << '\n';
+}
+
+void test_upgrades(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    // every pipe with twice its capacity, a new reservoir feeding each city and a pipe from each reservoir to it,
+    // in one batch, each against the network with the change solved again from scratch
+    std::vector<Upgrade> candidates;
+    for (Vertex *v: g.getVertexSet())
+        for (Edge *e: v->getAdj())
+            if (e->getDest() != g.getSink())
+                candidates.push_back({UPGRADE_PIPE, v, e->getDest(), e->getWeight() * 2, 0, 0});
+    unsigned reservoir = g.getReservoirVertexes().size() + 1;
+    for (auto c: g.getCityVertexes()) {
+        candidates.push_back({ADD_RESERVOIR, nullptr, c.second, 100, reservoir++, 100});
+        for (auto p: g.getReservoirVertexes())
+            candidates.push_back({ADD_PIPE, p.second, c.second, 50, 0, 0}); // not applied if the pipe is already there
+    }
+    candidates.push_back({ADD_RESERVOIR, nullptr, g.getCityVertexes().begin()->second, 100, 1, 100}); // taken type ID
+    std::vector<UpgradeReport> reports = g.evaluateUpgrades(candidates);
+    unsigned wrong = 0, gaining = 0, applied = 0;
+    for (unsigned i = 0; i < candidates.size(); i++) {
+        Graph copy(g);
+        Upgrade upgrade = candidates[i];
+        if (upgrade.orig != nullptr)
+            upgrade.orig = copy.getVertex(upgrade.orig->getIndex());
+        upgrade.dest = copy.getVertex(upgrade.dest->getIndex());
+        bool valid = copy.applyUpgrade(upgrade);
+        copy.resetFlow();
+        copy.edmondsKarp();
+        wrong += reports[i].applied != valid || copy.getFlow() - g.getFlow() != reports[i].total;
+        gaining += reports[i].total > 0;
+        applied += reports[i].applied;
+    }
+    std::cout << "Changes that bring more water: " << gaining << " / " << applied << " applied / " << candidates.size() << '\n'
+              << (wrong == 0 ? GREEN : RED) << "Upgrades whose incremental gain differs from a full re-solve: " << wrong
+              << ANSI_RESET << '\n';
+}
+
+void test_bottlenecks(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    // max-flow min-cut: the saturated arcs leaving the source side carry the whole flow
+    const ResidualGraph &r = g.getResidual();
+    FlowState s = g.getState();
+    std::vector<bool> sourceSide;
+    double cut = 0;
+    for (unsigned a: r.minCut(s, sourceSide))
+        cut += r.getCapacity(a);
+    std::cout << (cut == g.getFlow() ? GREEN : RED) << "Capacity of the minimum cut: " << cut << ", maximum flow: "
+              << g.getFlow() << ANSI_RESET << '\n';
+
+    unsigned needy = 0, grouped = 0;
+    for (auto c: g.getCityVertexes())
+        needy += c.second->getAdj()[0]->getFlow() < c.second->getDemand();
+    std::vector<Bottleneck> groups = g.bottlenecks();
+    for (const Bottleneck &b: groups)
+        grouped += b.cities.size();
+    std::cout << "Bottlenecks: " << groups.size() << '\n'
+              << (grouped == needy ? GREEN : RED) << "Cities missing water in a bottleneck: " << grouped << " / " << needy
+              << ANSI_RESET << '\n';
+}
+
+void test_balance(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    std::unordered_map<Vertex *, double> before;
+    for (auto c: g.getCityVertexes())
+        before[c.second] = c.second->getAdj()[0]->getFlow();
+    BalanceReport report = g.balanceFlow();
+
+    // the flow is still valid and every city gets the same water
+    unsigned wrong = 0;
+    for (Vertex *v: g.getVertexSet()) {
+        double in = 0, out = 0;
+        for (Edge *e: v->getIncoming()) in += e->getFlow();
+        for (Edge *e: v->getAdj()) {
+            out += e->getFlow();
+            wrong += e->getFlow() < 0 || e->getFlow() > e->getWeight();
+        }
+        wrong += in != out;
+    }
+    for (auto c: g.getCityVertexes())
+        wrong += before[c.second] != c.second->getAdj()[0]->getFlow();
+    std::cout << "Utilization cost: " << report.costBefore << " --> " << report.costAfter << ", augmentations: " << report.augmentations << '\n'
+              << (wrong == 0 && report.costAfter <= report.costBefore ? GREEN : RED)
+              << "Pipes out of bounds, vertexes not conserving water and cities getting other amounts: " << wrong << ANSI_RESET << '\n';
+}
+
+void test_removals(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    // every location on its own, as a scenario of one removal, against removing it and solving the copy again
+    std::vector<std::vector<FailurePoint>> scenarios;
+    for (Vertex *v: g.getVertexSet())
+        if (v != g.getSource() && v != g.getSink())
+            scenarios.push_back({{nullptr, v}});
+    std::vector<RemovalReport> reports = g.evaluateRemovals(scenarios);
+    unsigned wrong = 0, affecting = 0;
+    for (unsigned i = 0; i < scenarios.size(); i++) {
+        Graph copy(g);
+        copy.removeVertex(copy.getVertex(scenarios[i][0].station->getIndex()));
+        copy.maxFlow();
+        wrong += copy.getFlow() != reports[i].flow;
+        affecting += reports[i].flow != g.getFlow();
+    }
+    std::cout << "Locations whose removal takes water: " << affecting << " / " << scenarios.size() << '\n'
+              << (wrong == 0 ? GREEN : RED) << "Removals whose flow differs from removing the location: " << wrong
+              << ANSI_RESET << '\n';
+}
+
+void test_dependency(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    auto entries = [](const std::vector<std::pair<Edge *, Capacity>> &dependency) {
+        std::vector<std::pair<std::pair<unsigned, unsigned>, Capacity>> list;
+        for (const std::pair<Edge *, Capacity> &d: dependency)
+            list.push_back({{d.first->getOrig()->getIndex(), d.first->getDest()->getIndex()}, d.second});
+        std::sort(list.begin(), list.end());
+        return list;
+    };
+
+    Graph all(g);
+    all.calculateDependency();
+    unsigned wrong = 0, known = 0;
+    for (auto p: g.getCityVertexes()) {
+        const std::vector<std::pair<Edge *, Capacity>> &lazy = g.getDependency(p.second);
+        wrong += entries(lazy) != entries(all.getVertex(p.second->getIndex())->getDependency());
+        known += g.isDependencyKnown(p.second);
+    }
+    std::cout << "Cities cached: " << known << " / " << g.getCityVertexes().size() << '\n'
+              << (wrong == 0 ? GREEN : RED) << "Cities whose lazy dependency vector differs: " << wrong << ANSI_RESET << '\n';
+
+    for (auto p: g.getStationVertexes()) { // the first station whose removal changes the flow
+        Capacity before = g.getFlow();
+        g.removeVertex(p.second);
+        g.maxFlow();
+        if (g.getFlow() != before)
+            break;
+        g.restore();
+        g.maxFlow();
+    }
+    known = 0;
+    for (auto p: g.getCityVertexes())
+        known += g.isDependencyKnown(p.second);
+    std::cout << (known == 0 ? GREEN : RED) << "Cities still cached after a removal: " << known << ANSI_RESET << '\n';
+}
+
+void test_stats(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+    if (!Stats::enabled()) {
+        std::cout << "The statistics were compiled out\n";
+        return;
+    }
+
+    g.reset();
+    g.getResidual(); // the arrays are built before counting
+    Stats::reset();
+    unsigned iterations = g.edmondsKarp();
+    uint64_t searches = Stats::get(STAT_SEARCHES), paths = Stats::get(STAT_AUGMENTING_PATHS);
+    std::cout << "Arcs scanned: " << Stats::get(STAT_ARCS_SCANNED) << ", average path length: "
+              << (double) Stats::get(STAT_PATH_ARCS) / (double) paths << '\n'
+              << (searches == iterations && paths + 1 == iterations ? GREEN : RED) << "BFSs: " << iterations << ", searches counted: "
+              << searches << ", augmenting paths: " << paths << ANSI_RESET << '\n';
+}
+
+void test_k_failures(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    // the rankings do not depend on the threads, and a pair is only ranked if it takes more than each of its members alone
+    g.setThreads(1);
+    FailureReport serial = g.kFailures(2, 3);
+    g.setThreads(0);
+    FailureReport report = g.kFailures(2, 3), single = g.kFailures(1, report.points.size());
+    unsigned different = 0, wrong = 0, ranked = 0, pairs = 0;
+    for (auto c: g.getCityVertexes()) {
+        const std::vector<FailureScenario> &ranking = report.ranking[c.second], &other = serial.ranking[c.second];
+        different += ranking.size() != other.size();
+        for (unsigned i = 0; i < ranking.size() && i < other.size(); i++)
+            different += ranking[i].members != other[i].members || ranking[i].deficit != other[i].deficit;
+
+        std::unordered_map<unsigned, Capacity> alone; // failure points that take water from the city on their own
+        for (const FailureScenario &scenario: single.ranking[c.second])
+            alone[scenario.members[0]] = scenario.deficit;
+        for (unsigned i = 0; i < ranking.size(); i++) {
+            wrong += ranking[i].deficit > c.second->getAdj()[0]->getFlow() || (i > 0 && ranking[i].deficit > ranking[i - 1].deficit);
+            for (unsigned m: ranking[i].members)
+                wrong += ranking[i].deficit <= alone[m];
+        }
+        ranked += !ranking.empty();
+        pairs += ranking.size();
+    }
+    std::cout << "Cities ranked: " << ranked << " / " << g.getCityVertexes().size() << ", combinations evaluated: " << report.evaluated
+              << ", skipped: " << report.skipped << '\n'
+              << (different == 0 ? GREEN : RED) << "Rankings that differ between one thread and all of them: " << different << '\n'
+              << (wrong == 0 ? GREEN : RED) << "Pairs out of order, taking more than the city gets or no more than a member alone: " << wrong
+              << " / " << pairs << ANSI_RESET << '\n';
+}
+
+void test_simulation(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    // the same seed gives the same deficits on any number of threads, and certain failures take the whole flow
+    g.setThreads(1);
+    ReliabilityReport serial = g.simulateFailures(200, 0.05, 0.95, 7);
+    g.setThreads(0);
+    ReliabilityReport parallel = g.simulateFailures(200, 0.05, 0.95, 7), other = g.simulateFailures(200, 0.05, 0.95, 8);
+    unsigned wrong = serial.expectedTotal != parallel.expectedTotal || serial.percentileTotal != parallel.percentileTotal ||
+                     serial.failedPipes != parallel.failedPipes;
+    for (auto c: g.getCityVertexes())
+        wrong += serial.expected[c.second] != parallel.expected[c.second] || serial.percentile[c.second] != parallel.percentile[c.second];
+    ReliabilityReport none = g.simulateFailures(10, 0, 0.95, 7), all = g.simulateFailures(10, 1, 0.95, 7);
+    std::cout << "Expected water missing: " << serial.expectedTotal << " (seed 7), " << other.expectedTotal << " (seed 8), pipes failed: "
+              << serial.failedPipes << '\n'
+              << (wrong == 0 ? GREEN : RED) << "Cities whose deficits differ between two runs with the same seed: " << wrong << '\n'
+              << (none.expectedTotal == 0 && all.expectedTotal == (double) g.getFlow() ? GREEN : RED)
+              << "Water missing when no pipe fails: " << none.expectedTotal << ", when every pipe fails: " << all.expectedTotal
+              << ANSI_RESET << '\n';
+}
+
+void test_respond(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    std::vector<Vertex *> stations;
+    for (auto p: g.getStationVertexes())
+        stations.push_back(p.second);
+    std::sort(stations.begin(), stations.end(), [](const Vertex *a, const Vertex *b) { return a->getTypeId() < b->getTypeId(); });
+    const std::string station = stations[0]->getCode(), orig = stations[0]->getAdj()[0]->getOrig()->getCode(),
+                      dest = stations[0]->getAdj()[0]->getDest()->getCode();
+    std::vector<std::vector<std::string>> commands = {{"display_city", "-all"}, {"display_reservoir", "-all"}, {"display_station", "-all"},
+                                                      {"needy_cities"}, {"pipes_statistics"}, {"estimate", station}, {"estimate", orig, dest},
+                                                      {"display_city", "0"}, {"remove", station}, {"remove_pipe", orig, dest}};
+    for (auto p: g.getCityVertexes())
+        commands.push_back({"show_dependency", std::to_string(p.first)});
+
+    // the serial answers: the fields of query(), or the whole answer for the removals, which respond() evaluates itself
+    Runtime runtime(&g);
+    runtime.prepareQueries();
+    std::vector<std::string> expected;
+    for (unsigned i = 0; i < commands.size(); i++) {
+        if (commands[i][0] == "remove" || commands[i][0] == "remove_pipe") {
+            expected.push_back(runtime.respond(i, commands[i]));
+            continue;
+        }
+        std::ostringstream fields;
+        fields.precision(15);
+        std::string error;
+        bool ok = runtime.query(commands[i], fields, error);
+        expected.push_back("{\"line\":" + std::to_string(i) + ",\"command\":\"" + commands[i][0] + "\"" +
+                           (ok ? ",\"ok\":true" + fields.str() : ",\"ok\":false,\"error\":\"" + error + "\"") + "}\n");
+    }
+
+    // every thread answers all the commands a few times, each starting at a different one
+    const unsigned THREADS = 8, ROUNDS = 3;
+    std::vector<unsigned> wrong(THREADS, 0);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            for (unsigned r = 0; r < ROUNDS * commands.size(); r++) {
+                unsigned i = (t + r) % commands.size();
+                wrong[t] += runtime.respond(i, commands[i]) != expected[i];
+            }
+        });
+    }
+    for (std::thread &t: threads)
+        t.join();
+    unsigned different = 0;
+    for (unsigned w: wrong)
+        different += w;
+    std::cout << "Commands: " << commands.size() << ", answered " << ROUNDS << " times on each of " << THREADS << " threads\n"
+              << (different == 0 ? GREEN : RED) << "Answers that differ from the serial ones: " << different << " / "
+              << THREADS * ROUNDS * commands.size() << ANSI_RESET << '\n';
+}
+
+void test_snapshot(Graph g) {
+    std::cout << "\n=============================================================================================================\n";
+    std::cout << __func__ << '\n';
+
+    // every vertex, its edges in order with their capacity and flow, and the dependency vector of each city
+    auto describe = [](const Graph &network, unsigned &edges) {
+        std::ostringstream out;
+        out.precision(17);
+        edges = 0;
+        std::vector<const Vertex *> vertexes = {network.getSource(), network.getSink()};
+        vertexes.insert(vertexes.end(), network.getVertexSet().begin(), network.getVertexSet().end());
+        for (const Vertex *v: vertexes) {
+            out << v->getType() << ' ' << v->getId() << ' ' << v->getCode() << ':';
+            for (Edge *e: v->getAdj())
+                out << ' ' << e->getDest()->getCode() << '/' << e->getWeight() << '/' << e->getFlow();
+            edges += v->getAdj().size();
+            if (v->getType() == CITY && network.isDependencyKnown(v))
+                for (const std::pair<Edge *, Capacity> &d: v->getDependency())
+                    out << " -" << d.first->getOrig()->getCode() << '>' << d.first->getDest()->getCode() << '/' << d.second;
+            out << '\n';
+        }
+        return out.str();
+    };
+
+    // a CSV file of its own, so that changing it changes a hash the snapshot was written with
+    const std::string csv = "csv/Test.snapshot.csv", file = "csv/Test.snapshot";
+    std::ofstream(csv) << "Reservoir,Municipality,Id,Code,Maximum Delivery (m3/sec)\n";
+    std::vector<uint64_t> hashes = {hashFile(csv), 2, 3, 4};
+    g.calculateDependency();
+    bool written = writeSnapshot(g, file, hashes);
+
+    Graph loaded;
+    loaded.setAlgorithm(g.getAlgorithm());
+    bool read = written && loadSnapshot(loaded, file, hashes);
+    unsigned edges = 0, loadedEdges = 0;
+    bool same = read && describe(g, edges) == describe(loaded, loadedEdges) && loaded.getFlow() == g.getFlow();
+    std::cout << (written && read ? GREEN : RED) << "Snapshot written and loaded: " << (written && read ? "yes" : "no") << '\n'
+              << (same ? GREEN : RED) << "Vertexes: " << g.getVertexSet().size() << " --> " << loaded.getVertexSet().size()
+              << ", edges: " << edges << " --> " << loadedEdges << ", flow: " << g.getFlow() << " --> " << loaded.getFlow()
+              << ", capacities, flows and dependencies " << (same ? "equal" : "different") << '\n';
+
+    std::ofstream(csv, std::ios::app) << "Test,Test,1,R_1,1\n";
+    std::vector<uint64_t> changed = {hashFile(csv), 2, 3, 4};
+    Graph stale;
+    stale.setAlgorithm(g.getAlgorithm());
+    bool rejected = changed[0] != hashes[0] && !loadSnapshot(stale, file, changed) && stale.getVertexSet().empty();
+    std::cout << (rejected ? GREEN : RED) << "Snapshot rejected after a CSV file changed: " << (rejected ? "yes" : "no") << '\n';
+
+    // the mapping is validated before anything is read from it: a snapshot cut short, or an empty file, adds nothing
+    std::string bytes;
+    {
+        std::ifstream in(file, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    unsigned accepted = 0;
+    for (size_t size: {bytes.size() - 1, bytes.size() / 2, sizeof(SnapshotHeader), (size_t) 0}) {
+        std::ofstream(file, std::ios::binary | std::ios::trunc).write(bytes.data(), (std::streamsize) size);
+        Graph cut;
+        cut.setAlgorithm(g.getAlgorithm());
+        accepted += loadSnapshot(cut, file, hashes) || !cut.getVertexSet().empty();
+    }
+    std::cout << (accepted == 0 && !bytes.empty() ? GREEN : RED) << "Truncated or empty snapshots accepted: " << accepted << " / 4" << ANSI_RESET << '\n';
+    std::remove(csv.c_str());
+    std::remove(file.c_str());
+}
+
 void test_edge_statistics(Graph &g) {
     std::cout << "\n=============================================================================================================\n";
     std::cout << __func__ << '\n';
     print_statistics(g);
 }
 
-//! Time Complexity: O(V * E), Space Complexity: O(1)
+//! Time Complexity: O(V * E), Space Complexity: O(V + E)
 void test_suite(Graph &g) {
+    const Graph pristine(g); // the tests that take a copy start from it, whatever the tests before them removed
     test_edges(g);
     test_vertexes(g);
     test_cities(g);
     test_reservoirs(g);
     test_demand(g);
     test_capacity(g);
+    test_max_flow_algorithms(g);
     test_remove_vertexes(g);
     test_remove_edges(g);
     test_edge_statistics(g);
+    test_path_index(pristine);
+    test_components(pristine);
+    test_upgrades(pristine);
+    test_bottlenecks(pristine);
+    test_balance(pristine);
+    test_removals(pristine);
+    test_dependency(pristine);
+    test_stats(pristine);
+    test_k_failures(pristine);
+    test_simulation(pristine);
+    test_respond(pristine);
+    test_snapshot(pristine);
 }
@@ -11,29 +11,7 @@
 #include <utility>
 
 //! Time Complexity: O(1), Space Complexity: O(1)
-Vertex::Vertex(
-        node_type type,
-        unsigned int id,
-        const std::string reservoir,
-        const std::string municipality,
-        const std::string city,
-        unsigned int population) :
-        type(type), id(id), reservoir(reservoir), municipality(municipality), city(city), population(population) {}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-double Vertex::getDist() const {
-    return this->dist;
-}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-bool Vertex::isVisited() const {
-    return this->visited;
-}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-Edge *Vertex::getPath() const {
-    return this->path;
-}
+Vertex::Vertex(node_type type, unsigned int id, VertexInfo *info) : info(info), type(type), id(id) {}
 
 //! Time Complexity: O(1), Space Complexity: O(1)
 std::vector<Edge *> &Vertex::getAdj() {
@@ -56,26 +34,10 @@ const std::vector<Edge *> &Vertex::getIncoming() const noexcept {
 }
 
 //! Time Complexity: O(1), Space Complexity: O(1)
-void Vertex::setDist(double dist) {
-    this->dist = dist;
-}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-void Vertex::setVisited(bool visited) {
-    this->visited = visited;
-}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-void Vertex::setPath(Edge *path) {
-    this->path = path;
-}
-
-//! Time Complexity: O(1), Space Complexity: O(1)
-Edge *Vertex::addEdge(Vertex *dest, double w) {
-    Edge *newEdge = new Edge(this, dest, w);
-    adj.push_back(newEdge);
-    dest->incoming.push_back(newEdge);
-    return newEdge;
+Edge *Vertex::addEdge(Edge *e) {
+    adj.push_back(e);
+    e->getDest()->incoming.push_back(e);
+    return e;
 }
 
 //! Time Complexity: O(n), Space Complexity: O(1)
@@ -108,6 +70,11 @@ unsigned int Vertex::getTypeId() const {
     return this->id / 10;
 }
 
+//! Time Complexity: O(1), Space Complexity: O(1)
+unsigned int Vertex::getIndex() const {
+    return this->index;
+}
+
 std::string Vertex::getCode() const {
     switch (this->type) {
         case STATION:   return "PS_" + std::to_string(getTypeId());
@@ -128,50 +95,49 @@ node_type Vertex::getType() const {
 const std::string &Vertex::getReservoir() const {
     if (type != RESERVOIR)
         throw GraphException("Tried to get the reservoir name of a node that is not a reservoir");
-    return this->reservoir;
+    return this->info->reservoir;
 }
 
 //! Time Complexity: O(1), Space Complexity: O(1)
 const std::string &Vertex::getMunicipality() const {
     if (type != RESERVOIR)
         throw GraphException("Tried to get the municipality of a node that is not a municipality");
-    return this->municipality;
+    return this->info->municipality;
 }
 
 //! Time Complexity: O(1), Space Complexity: O(1)
 const std::string &Vertex::getCity() const {
     if (this->type != CITY)
         throw GraphException("Tried to get the city name of a node that is not a city");
-    return this->city;
+    return this->info->city;
 }
 
 //! Time Complexity: O(1), Space Complexity: O(1)
 unsigned int Vertex::getPopulation() const {
     if (this->type != CITY)
         throw GraphException("Tried to get the population of a node that is not a city");
-    return this->population;
+    return this->info->population;
 }
 
 //! Time Complexity: O(1), Space Complexity: O(1)
-double Vertex::getDemand() const {
+Capacity Vertex::getDemand() const {
     if (this->type != CITY)
         throw GraphException("Tried to get the demand of a node that is not a city");
     return this->adj[0]->getWeight();
 }
 
-//! Time Complexity: O(1), Space Complexity: O(1)
-Vertex *Vertex::getPrevious() const {
-    return (path->getDest() == this) ? path->getOrig() : path->getDest();
-}
-
-const std::vector<std::pair<Edge *, double>> &Vertex::getDependency() const {
+const std::vector<std::pair<Edge *, Capacity>> &Vertex::getDependency() const {
     if (this->type != CITY)
         throw GraphException("Tried to get the dependency vector of a node that is not a city");
-    return this->dependency;
+    return this->info->dependency;
 }
 
-void Vertex::addDependency(Edge *e, double value) {
+void Vertex::addDependency(Edge *e, Capacity value) {
     if (this->type != CITY)
         throw GraphException("Tried to add to the dependency vector of a node that is not a city");
-    this->dependency.emplace_back(e, value);
+    this->info->dependency.emplace_back(e, value);
+}
+
+void Vertex::clearDependency() {
+    this->info->dependency.clear();
 }
@@ -7,27 +7,167 @@
 
 #include <iostream>
 #include <cstring>
+#include <cctype>
+#include <iomanip>
+#include <fstream>
 
 #include "../lib/Graph.hpp"
 #include "../lib/Parser.hpp"
 #include "../lib/Tests.hpp"
 #include "../lib/Runtime.hpp"
+#include "../lib/Snapshot.hpp"
+#include "../lib/Server.hpp"
 
 
-//! If you want to execute edmondsKarp() followed by fordFulkerson(), make sure to call reset() between the two functions
-int main(int argc, char *argv[]) {
-    if (argc != 1 && !strcmp(argv[1], "-t")) {
-        Graph madeira = parse("csv/Cities_Madeira.csv", "csv/Pipes_Madeira.csv", "csv/Reservoirs_Madeira.csv", "csv/Stations_Madeira.csv");
-        madeira.fordFulkerson();  // max-flow: 24163
-        madeira.calculateDependency();
-        Runtime rt = Runtime(&madeira);
-        rt.run();
+/**
+ * @brief Counts the cities whose dependency vector is calculated for the current flow of a network
+ * @param const Graph& network: network
+ * @return unsigned: number of cities
+ * @note This function is static
+ * @note Time Complexity: O(C * E), Space Complexity: O(1)
+ */
+static unsigned knownDependencies(const Graph &network) {
+    unsigned known = 0;
+    for (auto p: network.getCityVertexes())
+        known += network.isDependencyKnown(p.second);
+    return known;
+}
+
+/**
+ * @brief Checks whether a copy of a network still has its vertexes, capacities, removals and flow
+ * @param const Graph& original: network the copy was made from
+ * @param const Graph& copy: copy, changed or not by the commands run on it
+ * @return bool: true if nothing that a snapshot stores was changed
+ * @note This function is static
+ * @note Time Complexity: O(V + E), Space Complexity: O(E)
+ */
+static bool unchanged(const Graph &original, const Graph &copy) {
+    const ResidualGraph &a = original.getResidual(), &b = copy.getResidual();
+    if (original.getIndexCount() != copy.getIndexCount() || a.arcCount() != b.arcCount())
+        return false;
+    FlowState x = original.getState(), y = copy.getState();
+    if (x.getFlows() != y.getFlows() || x.getRemoved() != y.getRemoved())
+        return false;
+    for (unsigned arc = 0; arc < a.arcCount(); arc++)
+        if (a.getCapacity(arc) != b.getCapacity(arc))
+            return false;
+    return true;
+}
+
+/**
+ * @brief Loads a dataset from its snapshot, or parses it, calculates its flow and writes the snapshot, then runs the CLI
+ * @param const std::vector<std::string>& files: cities, pipes, reservoirs and stations files
+ * @param const std::string& snapshot: snapshot file of the dataset
+ * @param bool useSnapshot: whether to read and write the snapshot
+ * @param max_flow_algorithm algorithm: maximum flow algorithm
+ * @param unsigned threads: threads of the failure analyses
+ * @param const std::string& batch: file of commands to run in batch mode, "-" for the standard input, or empty for the CLI
+ * @param const std::string& socket: path of the socket to serve queries on, or empty for the CLI
+ * @return void
+ * @note The snapshot is only used if the hashes of the 4 files and the algorithm match
+ * @note It is written again when the CLI, the batch or the server preparation leave more dependency vectors calculated, if the flow is still the saved one
+ * @note In batch mode the loading messages go to the standard error, so the standard output only has the JSON Lines
+ * @note Time Complexity: O(V + E) with a valid snapshot, O(V * E³) otherwise, Space Complexity: O(V + E)
+ */
+static void start(const std::vector<std::string> &files, const std::string &snapshot, bool useSnapshot,
+                  max_flow_algorithm algorithm, unsigned threads, const std::string &batch, const std::string &socket) {
+    std::streambuf *output = std::cout.rdbuf();
+    if (!batch.empty())
+        std::cout.rdbuf(std::cerr.rdbuf());
+    Graph network;
+    network.setAlgorithm(algorithm);
+    network.setThreads(threads);
+    std::vector<uint64_t> hashes;
+    for (const std::string &file: files)
+        hashes.push_back(hashFile(file));
+
+    if (useSnapshot && loadSnapshot(network, snapshot, hashes)) {
+        std::cout << WHITE << std::setw(17) << "Load Snapshot " << std::setw(18) << snapshot << GREEN << " OK" << WHITE << '\n';
     } else {
-        Graph network = parse("csv/Cities.csv", "csv/Pipes.csv", "csv/Reservoirs.csv", "csv/Stations.csv");
-        network.edmondsKarp();    // max-flow: 24163
-        network.calculateDependency();
-        Runtime rt = Runtime(&network);
+        parse(network, files[0], files[1], files[2], files[3]);
+        network.maxFlow();        // max-flow: 24163
+        if (useSnapshot && !writeSnapshot(network, snapshot, hashes))
+            std::cerr << "The snapshot " << snapshot << " could not be written\n";
+    }
+    // the dependency vectors calculated meanwhile go to the snapshot too, unless the commands changed the network
+    const unsigned known = knownDependencies(network);
+    Runtime rt(&network);
+    auto save = [&]() {
+        const Graph &now = rt.getNetwork();
+        if (useSnapshot && knownDependencies(now) > known && unchanged(network, now) && !writeSnapshot(now, snapshot, hashes))
+            std::cerr << "The snapshot " << snapshot << " could not be written\n";
+    };
+    if (!socket.empty()) {
+        rt.prepareQueries();
+        save();
+        Server server(rt, socket, threads);
+        std::cout << "Serving queries on " << socket << '\n' << std::flush;
+        if (!server.run())
+            std::cerr << "The socket " << socket << " could not be created\n";
+        return;
+    }
+    if (batch.empty()) {
         rt.run();
+        save();
+        return;
+    }
+    std::cout.rdbuf(output);
+    if (batch == "-") {
+        rt.runBatch(std::cin, std::cout);
+        save();
+        return;
+    }
+    std::ifstream file(batch);
+    if (!file.is_open()) {
+        std::cerr << "The file " << batch << " could not be opened\n";
+        return;
+    }
+    rt.runBatch(file, std::cout);
+    save();
+}
+
+//! If you want to execute edmondsKarp() followed by fordFulkerson(), make sure to call reset() between the two functions
+//! Usage: ./main [-t] [-a edmonds_karp | ford_fulkerson | dinic | push_relabel] [-j threads] [-n] [-b file | -] [-s socket]
+//!     -t: uses the Madeira dataset
+//!     -a: selects the maximum flow algorithm (Edmonds-Karp by default, Ford-Fulkerson with -t)
+//!     -j: number of threads of the failure analyses (0, the default, uses one per core)
+//!     -n: neither reads nor writes the snapshot of the dataset
+//!     -b: runs the commands of a file ("-" for the standard input) and writes JSON Lines instead of starting the CLI
+//!     -s: loads the network once and answers queries from many clients on a Unix domain socket instead of starting the CLI
+int main(int argc, char *argv[]) {
+    bool madeira = false, useSnapshot = true, chosen = false;
+    max_flow_algorithm algorithm = EDMONDS_KARP;
+    unsigned threads = 0;
+    std::string batch, socket;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t")) {
+            madeira = true;
+        } else if (!strcmp(argv[i], "-n")) {
+            useSnapshot = false;
+        } else if (!strcmp(argv[i], "-a") && i + 1 < argc && Graph::parseAlgorithm(argv[i + 1], algorithm)) {
+            chosen = true;
+            i++;
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc && isdigit(argv[i + 1][0])) {
+            threads = std::stoul(argv[++i]);
+        } else if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+            batch = argv[++i];
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            socket = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [-t] [-a edmonds_karp | ford_fulkerson | dinic | push_relabel] [-j threads] [-n] [-b file | -] [-s socket]\n";
+            return 1;
+        }
     }
+
+    if (!batch.empty())
+        std::ios::sync_with_stdio(false); // the JSON Lines are written in large blocks, not one field at a time
+    if (madeira && !chosen)
+        algorithm = FORD_FULKERSON; // the flow Madeira has always been solved with, so its pipes keep the same flows
+    if (madeira)
+        start({"csv/Cities_Madeira.csv", "csv/Pipes_Madeira.csv", "csv/Reservoirs_Madeira.csv", "csv/Stations_Madeira.csv"},
+              "csv/Madeira.snapshot", useSnapshot, algorithm, threads, batch, socket);
+    else
+        start({"csv/Cities.csv", "csv/Pipes.csv", "csv/Reservoirs.csv", "csv/Stations.csv"},
+              "csv/Network.snapshot", useSnapshot, algorithm, threads, batch, socket);
     return 0;
 }